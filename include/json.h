@@ -3,6 +3,7 @@
 #ifndef JSON_H_INCLUDED
 #define JSON_H_INCLUDED
 
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -12,6 +13,11 @@ extern "C" {
 
 typedef struct json_t json_t;
 typedef char (*json_getc_t)(void*);
+///
+///@brief Block source of input
+///@return count of symbols stored to buf (not more than size). 0 - end of input or error
+///
+typedef size_t (*json_read_t)(void* data, char* buf, size_t size);
 
 extern const char JSON_NULL[];
 extern const char JSON_TRUE[];
@@ -23,16 +29,108 @@ extern const char JSON_OBJECT[];
 
 json_t* json_init_from_value(const char* type, const char* value);
 json_t* json_init_from(json_getc_t getc, void* data);
+///
+///@brief Parse json value from block source
+/// \n Input is requested by blocks, so symbols after value may be taken from source and lost
+///
+json_t* json_init_from_reader(json_read_t read, void* data);
+///
+///@brief Parse json value from file descriptor (file, pipe, socket)
+/// \n Input is read by blocks, so symbols after value may be taken from fd and lost
+///
+json_t* json_init_from_fd(int fd);
+///
+///@brief Parse json value from file
+/// \n Seekable stream is read by blocks, symbols after value are returned to it.
+/// Other streams (pipes, terminals) are read by symbols, so next value may be parsed by next call.
+///
 json_t* json_init_from_file(FILE* file);
+///
+///@brief Parse json value from file at path
+/// \n Regular file is mapped into memory and parsed without copying,
+/// other files are read by blocks. Only spaces are allowed after value in regular file.
+///
+json_t* json_init_from_path(const char* path);
 json_t* json_init_from_str(const char* value, const char** endptr);
+///
+///@brief Parse json value from buffer with known length
+///@param data buffer to parse. NUL symbol not required at the end
+///@param len size of data
+///@param consumed if not NULL - count of symbols used by value.
+/// \n In case of error - offset of wrong symbol
+///@return parsed value. In case of error return NULL.
+///
+json_t* json_init_from_buf(const char* data, size_t len, size_t* consumed);
+///
+///@brief Parse from buffer only parts of value selected by JSON Pointer (RFC 6901) paths
+/// \n Object members not on paths are dropped, array elements not on paths are replaced by null,
+/// so indexes of selected elements are kept. Missed paths are ignored.
+/// \n Parts not selected are skipped without allocations and are not validated.
+/// Only spaces are allowed after value.
+///@param paths JSON Pointers, e.g. "/items/0/id". "" selects whole value
+///@param count count of paths
+///@return selected parts of value. In case of parsing error or wrong path return NULL.
+///
+json_t* json_init_from_buf_projected(const char* data, size_t len, const char* const* paths, size_t count);
+///
+///@brief Deep copy of value, strings and numbers are shared with value by reference counter
+/// \n Counters are atomic only in library built with JSON_ATOMIC_REFCNT,
+/// in other builds copy and value should be used by one thread.
+///
 json_t* json_copy(json_t** self);
+///
+///@brief Copy of value sharing its containers with value by reference counters
+/// \n Only root of value is copied, so large documents are copied in time of their top level.
+/// Value of arena or referencing input buffer (see json_parser_set_views()) is deep copied into heap.
+/// \n Containers are shared by value and its copies till one of them is changed.
+/// json_set_by_*(), json_get_mut_by_*(), json_reserve() and json_shrink_to_fit() replace
+/// container shared in self by its own shallow copy, so only containers on path to changed value
+/// are copied, and they may fail on allocation. Nested values of value and its copies should be
+/// changed through slots given by json_get_mut_by_*(), slots of json_get_by_*() are for reading only.
+/// \n Counters are atomic only in library built with JSON_ATOMIC_REFCNT,
+/// in other builds copy and value should be used by one thread.
+///
+json_t* json_copy_shared(json_t** self);
+///
+///@brief Release value owned by user and set self to NULL
+/// \n Has no effect for values stored in containers
+///
 void json_deinit(json_t** self);
 
 const char* json_get_type(json_t** self);
 const char* json_get_str(json_t** self);
+///
+///@brief Same as json_get_str() but symbols may be not NUL terminated
+/// \n Strings referencing input buffer (see json_parser_set_views()) are returned without copying
+///@param len [out] count of symbols
+///
+const char* json_get_strn(json_t** self, size_t* len);
+///
+///@brief Get value of number as integer, binary value is calculated once on creation of number
+///@param value [out] value of number
+///@return 0 - success, -1 - not a number or not integer fitting int64 (e.g. 1.5, 1e20)
+/// \n Numbers with fraction or exponent having integer value (e.g. 1.0, 2e3) are accepted
+///
+int json_get_int64(json_t** self, int64_t* value);
+///
+///@brief Get value of number as double, nearest to its text
+///@param value [out] value of number, integers beyond 2^53 are rounded
+///@return 0 - success, -1 - not a number or number out of double range
+///
+int json_get_double(json_t** self, double* value);
 
 size_t json_size(json_t** self);
+///
+///@brief Get slot of array element or object value by id
+/// \n Container shared by copies (see json_copy_shared()) is not copied, so slot of it is for reading only
+///
 json_t** json_get_by_id(json_t** self, size_t id);
+///
+///@brief Same as json_get_by_id() but slot may be used to change value
+/// \n Container shared by copies is copied before (see json_copy_shared()), so self value may be changed
+/// and NULL is returned if copying fails
+///
+json_t** json_get_mut_by_id(json_t** self, size_t id);
 
 ///
 ///@brief Set json value by id
@@ -51,8 +149,15 @@ json_t** json_get_by_id(json_t** self, size_t id);
 json_t** json_set_by_id(json_t** self, json_t** elem, size_t id);
 
 const char* json_key(json_t** self, size_t id);
+///
+///@brief Same as json_get_by_id() for value of key
+///
 json_t** json_get_by_key(json_t** self, const char* key);
 ///
+///@brief Same as json_get_mut_by_id() for value of key
+///
+json_t** json_get_mut_by_key(json_t** self, const char* key);
+///
 ///@brief Set json value by key
 ///@param self pointer to containter to set
 /// \n self value may be changed
@@ -70,6 +175,20 @@ json_t** json_get_by_key(json_t** self, const char* key);
 json_t** json_set_by_key(json_t** self_ptr, json_t** value, const char* key);
 
 json_t** json_set(json_t** dst, json_t** src); // not tested
+///
+///@brief Allocate room for capacity elements of array or pairs of object
+/// \n Adding of elements up to capacity does not reallocate container.
+/// Containers grow geometrically anyway, reserving avoids intermediate copies.
+/// \n self value may be changed
+///@return self. In case of error return NULL, elements of self are not changed
+///
+json_t** json_reserve(json_t** self, size_t capacity);
+///
+///@brief Release room of container not used by its elements
+/// \n Containers of arena are not changed. self value may be changed
+///@return self. In case of error return NULL, elements of self are not changed
+///
+json_t** json_shrink_to_fit(json_t** self);
 
 #ifdef __cplusplus
 }
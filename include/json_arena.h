@@ -0,0 +1,42 @@
+/// Copyright © Alexander Kaluzhnyy
+
+#ifndef JSON_ARENA_H_INCLUDED
+#define JSON_ARENA_H_INCLUDED
+
+#include "json.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+///
+///@brief Memory of documents released at once
+/// \n Nodes are allocated from arena blocks by bump pointer. json_deinit() does nothing
+/// for them, all nodes are released by json_arena_deinit().
+/// \n Rules for values of different arenas and heap:
+/// - container of arena keeps only nodes of the same arena, container created by
+///   other functions keeps only heap nodes;
+/// - json_set*() copies element of other arena or heap into memory of container.
+///   Element created by user and not set anywhere is released after copying
+///   (nothing is done for element of arena) and changed to new place of store;
+/// - growing container of arena is copied to new place of arena, old place is not reused;
+/// - json_copy() always creates heap value.
+/// \n Arena may be used by one thread at a time.
+///
+typedef struct json_arena_t json_arena_t;
+
+json_arena_t* json_arena_init(void);
+///
+///@brief Release arena with all values created in it
+///
+void json_arena_deinit(json_arena_t** self);
+///
+///@brief Same as json_init_from_value() but value created in arena
+///
+json_t* json_arena_init_from_value(json_arena_t* arena, const char* type_str, const char* value_str);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JSON_ARENA_H_INCLUDED
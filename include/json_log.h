@@ -0,0 +1,67 @@
+/// Copyright © Alexander Kaluzhnyy
+
+#ifndef JSON_LOG_H_INCLUDED
+#define JSON_LOG_H_INCLUDED
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+///
+///@brief Levels of library log, each level includes messages of previous ones
+///
+typedef enum json_log_level_t {
+    JSON_LOG_NONE, ///< nothing is logged
+    JSON_LOG_ERROR, ///< errors of calls (default)
+    JSON_LOG_DEBUG, ///< values handled by functions
+    JSON_LOG_TRACE, ///< enters and exits of functions
+} json_log_level_t;
+
+///
+///@brief Set level of messages written to log
+/// \n Messages above level are skipped before formatting of their arguments.
+/// Library built with JSON_NO_LOG has no debug and trace messages at all.
+///
+void json_log_set_level(json_log_level_t level);
+json_log_level_t json_log_get_level(void);
+
+///
+///@brief Destination of log
+///@param data user data given to json_log_set_sink()
+///@param text whole lines of log, not NUL terminated
+///
+typedef void (*json_log_sink_t)(void* data, const char* text, size_t len);
+
+///
+///@brief Set destination of log, it should be set while nothing is logged
+/// \n Synchronous log calls sink from logging threads, asynchronous - from drain thread only.
+///@param sink NULL - stdout (default)
+///
+void json_log_set_sink(json_log_sink_t sink, void* data);
+///
+///@brief Start asynchronous log: records are put to lock-free ring and
+/// written to sink by batches from background thread
+/// \n Logging threads never wait: records are dropped when ring is full,
+/// count of dropped records is written to log. Records have fixed size, so longer
+/// messages are truncated and end with "...". Synchronous log does not truncate messages.
+///@param capacity count of records in ring, rounded up to power of 2
+///@return 0 - started, -1 - already started or error
+///
+int json_log_async_start(size_t capacity);
+///
+///@brief Write all records logged before the call and stop background thread,
+/// log becomes synchronous. Threads logging during the call are waited for.
+///
+void json_log_async_stop(void);
+///
+///@brief Wait till records logged before the call are written to sink
+///
+void json_log_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JSON_LOG_H_INCLUDED
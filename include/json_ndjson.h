@@ -0,0 +1,40 @@
+/// Copyright © Alexander Kaluzhnyy
+
+#ifndef JSON_NDJSON_H_INCLUDED
+#define JSON_NDJSON_H_INCLUDED
+
+#include "json.h"
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+///
+///@brief Callback for records of NDJSON (JSON Lines) input
+///@param data user data
+///@param line number of input line, starting from 0
+///@param value parsed record owned by callback, NULL if line is not valid JSON
+///@return 0 - continue, other value - stop reading
+///
+typedef int (*json_ndjson_callback_t)(void* data, size_t line, json_t* value);
+
+///
+///@brief Split NDJSON input into records and parse them by pool of threads
+/// \n Blank lines are skipped. Callback is called from calling thread only.
+///@param threads count of parsing threads, 0 - count of online processors
+///@param ordered 1 - records delivered in order of input,
+/// 0 - records delivered as soon as parsed
+///@return 0 - all records delivered, -1 - error or reading stopped by callback
+///
+int json_ndjson_parse_buf(const char* data, size_t len, size_t threads, int ordered, json_ndjson_callback_t callback, void* user_data);
+///
+///@brief Same as json_ndjson_parse_buf() but input read from file by blocks till end of file
+///
+int json_ndjson_parse_file(FILE* file, size_t threads, int ordered, json_ndjson_callback_t callback, void* user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JSON_NDJSON_H_INCLUDED
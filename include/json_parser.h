@@ -0,0 +1,151 @@
+/// Copyright © Alexander Kaluzhnyy
+
+#ifndef JSON_PARSER_H_INCLUDED
+#define JSON_PARSER_H_INCLUDED
+
+#include "json.h"
+#include "json_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+///
+///@brief Reusable parser context
+/// \n Keeps scratch buffers between parsings, so parsing of many values
+/// with the same parser avoids repeated allocations.
+/// \n Parser may be used by one thread at a time.
+///
+typedef struct json_parser_t json_parser_t;
+
+json_parser_t* json_parser_init(void);
+void json_parser_deinit(json_parser_t** self);
+///
+///@brief Limit nesting of containers in parsed values
+///@param max_depth max count of nested containers. 0 - no limit (default)
+/// \n Values with deeper nesting cause parsing error
+///
+void json_parser_set_max_depth(json_parser_t* self, size_t max_depth);
+///
+///@brief Keep object keys interned by parser between parsings
+/// \n Repeated keys of parsed value always share one refcounted node.
+/// With keep set, keys are shared by all values parsed till keep reset or parser deinit.
+/// Values sharing keys may be used by other threads only if library is built
+/// with JSON_ATOMIC_REFCNT, otherwise they should be used by thread using parser.
+///@param keep 1 - keep keys, 0 - drop kept keys and keep keys during one parsing only (default)
+///
+void json_parser_set_keep_keys(json_parser_t* self, int keep);
+///
+///@brief Create parsed values in arena
+///@param arena arena for values, NULL - heap (default)
+/// \n Keys are not kept between parsings into arena
+///
+void json_parser_set_arena(json_parser_t* self, json_arena_t* arena);
+///
+///@brief Reference strings of input buffer instead of copying them
+/// \n String values without escapes parsed by json_parser_parse_buf() keep pointer into data,
+/// so data should not be changed or freed till parsed values are deinited.
+/// Copies of values (e.g. made by json_copy()) and values stored into other containers do not reference data.
+/// \n Use json_get_strn() to read such strings without copying, json_get_str() makes
+/// NUL terminated copy on the first call and keeps it till string is deinited.
+/// Strings parsed from reader and object keys are always copied.
+///@param views 1 - reference strings, 0 - copy strings (default)
+///
+void json_parser_set_views(json_parser_t* self, int views);
+
+///
+///@brief Same as json_init_from_buf() but use buffers of parser
+///
+json_t* json_parser_parse_buf(json_parser_t* self, const char* data, size_t len, size_t* consumed);
+///
+///@brief Same as json_parser_parse_buf() but strings are decoded in place of data
+/// \n Each string value and object key is unescaped into data and NUL terminated in place of
+/// its closing quote, so json_get_str() and json_key() return pointers into data without copying.
+/// Only nodes of strings are allocated, in arena of parser if it is set (see json_parser_set_arena()).
+/// Keys are not interned (see json_parser_set_keep_keys()).
+/// Data is changed even if parsing fails, it should not be changed or freed
+/// till parsed value is deinited. Copies of value do not reference data.
+///
+json_t* json_parser_parse_insitu(json_parser_t* self, char* data, size_t len, size_t* consumed);
+///
+///@brief Same as json_init_from_reader() but use buffers of parser
+///
+json_t* json_parser_parse_reader(json_parser_t* self, json_read_t read, void* data);
+
+///
+///@brief Handlers of parsing events, value tree is not built
+/// \n Each handler gets user data and returns 0 to continue or other value to stop parsing.
+/// NULL handler ignores its events.
+/// \n Strings passed to handlers are decoded, not NUL terminated in general
+/// and valid till return from handler.
+///
+typedef struct json_sax_t {
+    int (*on_null)(void* data);
+    int (*on_bool)(void* data, int value);
+    int (*on_number)(void* data, const char* str, size_t len);
+    int (*on_string)(void* data, const char* str, size_t len);
+    int (*on_key)(void* data, const char* str, size_t len);
+    int (*on_start_object)(void* data);
+    int (*on_end_object)(void* data);
+    int (*on_start_array)(void* data);
+    int (*on_end_array)(void* data);
+} json_sax_t;
+
+///
+///@brief Parse value from buffer calling handlers of sax for its parts
+/// \n Buffers of parser are reused, so parsing with warmed up parser does not allocate memory
+///@param consumed [out] same as for json_init_from_buf()
+///@return 0 - value parsed, -1 - parsing error or stopped by handler
+///
+int json_parser_sax_buf(json_parser_t* self, const json_sax_t* sax, void* user_data, const char* data, size_t len, size_t* consumed);
+///
+///@brief Same as json_parser_sax_buf() but input is taken from read
+///
+int json_parser_sax_reader(json_parser_t* self, const json_sax_t* sax, void* user_data, json_read_t read, void* data);
+
+///
+///@brief Push parser for input received by parts (e.g. from non-blocking sockets)
+/// \n Keeps state of value not finished (opened containers, read part of string or key)
+/// between feedings, so input does not need to be collected before parsing.
+/// Decoded part of string or key not finished is kept in scratch buffer of parser.
+/// Input symbols of number, literal or escape sequence in string not finished
+/// are kept by parser till next feeding.
+/// \n Parser may be used by one thread at a time.
+///
+typedef struct json_push_parser_t json_push_parser_t;
+
+typedef enum json_push_status_t {
+    JSON_PUSH_ERROR = -1, ///< parsing error, partially parsed value dropped
+    JSON_PUSH_NEED_MORE, ///< all input consumed, value is not finished yet
+    JSON_PUSH_DONE, ///< value parsed, it may be taken by json_push_take()
+} json_push_status_t;
+
+json_push_parser_t* json_push_init(void);
+void json_push_deinit(json_push_parser_t** self);
+///
+///@brief Same as json_parser_set_max_depth()
+///
+void json_push_set_max_depth(json_push_parser_t* self, size_t max_depth);
+///
+///@brief Feed next part of input
+///@param consumed [out] count of symbols used from data: all of them for JSON_PUSH_NEED_MORE,
+/// up to end of value for JSON_PUSH_DONE. Rest of data should be fed for next value.
+/// \n Top level number can't be finished till non-number symbol or json_push_finish()
+///
+json_push_status_t json_push_feed(json_push_parser_t* self, const char* data, size_t len, size_t* consumed);
+///
+///@brief Notify parser about end of input
+///@return JSON_PUSH_DONE if value finished, JSON_PUSH_ERROR if input ended inside value or has no value
+///
+json_push_status_t json_push_finish(json_push_parser_t* self);
+///
+///@brief Take parsed value, after that parser is ready for next value
+///@return value owned by caller or NULL if value is not parsed yet
+///
+json_t* json_push_take(json_push_parser_t* self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JSON_PARSER_H_INCLUDED
@@ -0,0 +1,34 @@
+/// Copyright © Alexander Kaluzhnyy
+
+#ifndef JSON_POOL_H_INCLUDED
+#define JSON_POOL_H_INCLUDED
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+///
+///@brief Allocate heap nodes from pools of size classes instead of calloc()
+/// \n Each thread keeps its own lists of free nodes, they are refilled by batches from shared
+/// slabs taken from system allocator, so threads creating values do not contend for malloc.
+/// Node released by other thread goes to pool of releasing thread.
+/// \n Nodes bigger than largest class and memory of object indexes are allocated as usual.
+///@param enable 1 - use pools, 0 - use calloc() (default). Nodes taken from pools before
+/// disabling are returned to pools on release.
+///
+void json_pool_set_enabled(int enable);
+///
+///@brief Return slabs without used nodes to system allocator, e.g. on memory pressure
+/// \n Free nodes of calling thread are returned to shared slabs first. Free nodes of other threads
+/// are returned when they exit, so their slabs stay till then.
+///@return count of bytes returned to system allocator
+///
+size_t json_pool_trim(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JSON_POOL_H_INCLUDED
@@ -0,0 +1,99 @@
+/// Copyright © Alexander Kaluzhnyy
+
+#include "arena.h"
+#include "log.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_BLOCK_SIZE (64 * 1024)
+#define ARENA_ALIGN 16
+#define ARENA_BIG_SIZE (ARENA_BLOCK_SIZE / 4)
+
+///
+///@brief Header of block, block is aligned by ARENA_BLOCK_SIZE
+/// \n Big allocations get own block of several ARENA_BLOCK_SIZE, they start in first part of it.
+///
+typedef struct arena_block_t {
+    json_arena_t* arena;
+    struct arena_block_t* next;
+} arena_block_t;
+
+_Static_assert(sizeof(arena_block_t) % ARENA_ALIGN == 0, "data of block is not aligned");
+
+struct json_arena_t {
+    arena_block_t* blocks;
+    char* pos; ///< free part of current block
+    char* end;
+};
+
+static arena_block_t* json_arena_block(json_arena_t* self, size_t size)
+{
+    size_t total = (sizeof(arena_block_t) + size + ARENA_BLOCK_SIZE - 1) & ~(size_t)(ARENA_BLOCK_SIZE - 1);
+    arena_block_t* block = aligned_alloc(ARENA_BLOCK_SIZE, total);
+    if (block == NULL) {
+        log_error_msg("aligned_alloc(): %s(%i)", strerror(errno), errno);
+        return NULL;
+    }
+    log_debug_msg("new block %p of %zu", block, total);
+    block->arena = self;
+    block->next = self->blocks;
+    self->blocks = block;
+    return block;
+}
+
+json_arena_t* json_arena_init(void)
+{
+    log_trace_func();
+    json_arena_t* self = calloc(1, sizeof(json_arena_t));
+    if (self == NULL) {
+        log_error_msg("calloc(): %s(%i)", strerror(errno), errno);
+    }
+    return self;
+}
+
+void json_arena_deinit(json_arena_t** self)
+{
+    log_trace_func();
+    if (self == NULL || *self == NULL) {
+        log_error_msg("arena is NULL");
+        return;
+    }
+    for (arena_block_t* block = (*self)->blocks; block != NULL;) {
+        arena_block_t* next = block->next;
+        free(block);
+        block = next;
+    }
+    free(*self);
+    *self = NULL;
+}
+
+void* json_arena_alloc(json_arena_t* self, size_t size)
+{
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if ((size_t)(self->end - self->pos) < size) {
+        if (size > ARENA_BIG_SIZE) {
+            // current block stays in use for small allocations
+            arena_block_t* block = json_arena_block(self, size);
+            if (block == NULL) {
+                return NULL;
+            }
+            return memset(block + 1, 0, size);
+        }
+        arena_block_t* block = json_arena_block(self, ARENA_BLOCK_SIZE - sizeof(arena_block_t));
+        if (block == NULL) {
+            return NULL;
+        }
+        self->pos = (char*)(block + 1);
+        self->end = (char*)block + ARENA_BLOCK_SIZE;
+    }
+    void* data = self->pos;
+    self->pos += size;
+    return memset(data, 0, size);
+}
+
+json_arena_t* json_arena_of(const void* ptr)
+{
+    return ((const arena_block_t*)((uintptr_t)ptr & ~(uintptr_t)(ARENA_BLOCK_SIZE - 1)))->arena;
+}
@@ -0,0 +1,28 @@
+/// Copyright © Alexander Kaluzhnyy
+
+#ifndef ARENA_H_INCLUDED
+#define ARENA_H_INCLUDED
+
+#include "json_arena.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+///
+///@brief Allocate zero filled memory from arena by bump pointer
+///@return pointer aligned for any type. NULL in case of allocation error
+///
+void* json_arena_alloc(json_arena_t* self, size_t size);
+///
+///@brief Arena owning memory returned by json_arena_alloc()
+/// \n Blocks of arena are aligned by their size, so owner is found by address
+///
+json_arena_t* json_arena_of(const void* ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_H_INCLUDED
@@ -1,12 +1,24 @@
 /// Copyright © Alexander Kaluzhnyy
 
+// strtod_l()
+#define _GNU_SOURCE
 #include "json.h"
+#include "json_parser.h"
+#include "arena.h"
 #include "log.h"
-#include <ctype.h>
+#include "pool.h"
+#include "scan.h"
+#include "stack.h"
 #include <limits.h>
+#include <locale.h>
+#include <math.h>
 #include <string.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 const char JSON_NULL[] = "null";
 const char JSON_TRUE[] = "true";
@@ -56,28 +68,88 @@ typedef struct json_arr_t {
 typedef struct json_t {
     json_type_t type : bit_required(JSON_TYPE_SIZE);
     unsigned have_root : 1;
+    unsigned in_arena : 1; ///< node is released with its arena only
+    unsigned is_view : 1; ///< string symbols are in input buffer, see view
+    unsigned in_pool : 1; ///< node is allocated by json_pool_alloc()
+    unsigned has_views : 1; ///< container or its elements reference input buffer, see json_has_views()
+    unsigned capacity; ///< count of nodes allocated for container, it fills padding before union
     union {
         struct {
             unsigned refcnt;
             char str[];
         } str;
+        struct {
+            unsigned refcnt;
+            unsigned len;
+            const char* data; ///< symbols in input buffer, not NUL terminated
+            char* copy[]; ///< one slot for NUL terminated copy made by json_get_str()
+        } view;
         struct {
             unsigned size;
+            unsigned refcnt; ///< containers of heap are shared by copies, see json_unshare()
+            struct json_index_t* index; ///< hash index of object keys, NULL for small objects
             json_t* nodes[];
         } arr;
+        struct {
+            unsigned refcnt;
+            unsigned is_int : 1; ///< value kept in i, otherwise in d
+            union {
+                int64_t i;
+                double d;
+            };
+            char str[];
+        } num;
     };
 } json_t;
 
-json_t node_null = { JSON_TYPE_NULL, 0, { { 0 } } };
-json_t node_true = { JSON_TYPE_TRUE, 0, { { 0 } } };
-json_t node_false = { JSON_TYPE_FALSE, 0, { { 0 } } };
+_Static_assert(sizeof(json_t) == 24, "header of node is not packed");
+
+json_t node_null = { JSON_TYPE_NULL, 0, 0, 0, 0, 0, 0, { { 0 } } };
+json_t node_true = { JSON_TYPE_TRUE, 0, 0, 0, 0, 0, 0, { { 0 } } };
+json_t node_false = { JSON_TYPE_FALSE, 0, 0, 0, 0, 0, 0, { { 0 } } };
+
+///
+///@brief Rooted twins of node_null, node_true and node_false for elements of containers
+/// \n Root flag of shared node is never changed, so values of user and elements use different nodes
+///
+static json_t stored_null = { JSON_TYPE_NULL, 1, 0, 0, 0, 0, 0, { { 0 } } };
+static json_t stored_true = { JSON_TYPE_TRUE, 1, 0, 0, 0, 0, 0, { { 0 } } };
+static json_t stored_false = { JSON_TYPE_FALSE, 1, 0, 0, 0, 0, 0, { { 0 } } };
+
+///
+///@brief Mark node stored in container as rooted
+///@return node to be stored: null, true and false are replaced by their rooted twins
+///
+static json_t* json_node_stored(json_t* node)
+{
+    if (node == &node_null) {
+        return &stored_null;
+    }
+    if (node == &node_true) {
+        return &stored_true;
+    }
+    if (node == &node_false) {
+        return &stored_false;
+    }
+    if (!node->have_root) {
+        node->have_root = 1;
+    }
+    return node;
+}
 
+///
+///@brief Count of references to node
+/// \n Load is acquire: owner of the only reference sees all reads of node by released references
+///
 static unsigned json_refcnt(const json_t* self)
 {
     switch (self->type) {
     case JSON_TYPE_NUMBER:
     case JSON_TYPE_STRING:
-        return self->str.refcnt;
+        return __atomic_load_n(&self->str.refcnt, __ATOMIC_ACQUIRE);
+    case JSON_TYPE_ARRAY:
+    case JSON_TYPE_OBJECT:
+        return __atomic_load_n(&self->arr.refcnt, __ATOMIC_ACQUIRE);
     default:
         break;
     }
@@ -138,13 +210,26 @@ static unsigned json_refcnt(const json_t* self)
     pptr##_value;                             \
 })
 
+///
+///@brief Reference counters of shared nodes, atomic in build with JSON_ATOMIC_REFCNT
+/// \n Increment is relaxed: new reference is made from existing one. Decrement is acq_rel,
+/// so releasing thread sees all changes of node made by other owners.
+///
+#ifdef JSON_ATOMIC_REFCNT
+#define REFCNT_INC(cnt) ((void)__atomic_fetch_add(&(cnt), 1, __ATOMIC_RELAXED))
+#define REFCNT_DEC(cnt) __atomic_sub_fetch(&(cnt), 1, __ATOMIC_ACQ_REL)
+#else
+#define REFCNT_INC(cnt) ((void)(cnt)++)
+#define REFCNT_DEC(cnt) (--(cnt))
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// INPUT
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 static const char* symbol_str(char c)
 {
-    static char holder[] = "0x00";
+    static _Thread_local char holder[] = "0x00";
     switch (c) {
     case 0x20 ... 0x7E:
         sprintf(holder, "'%c'", c);
@@ -156,27 +241,108 @@ static const char* symbol_str(char c)
     return holder;
 }
 
-typedef struct reader_t {
-    json_getc_t getc;
-    void* data;
-    char current;
+#define READER_BLOCK_SIZE (64 * 1024)
+#define PARSER_TMP_MIN_SIZE 64
+#define PARSER_KEYS_MIN_SIZE 64
+#define PARSER_KEYS_MAX_COUNT (64 * 1024)
+
+typedef enum parse_state_t {
+    PARSE_VALUE, ///< value expected
+    PARSE_STRING, ///< rest of string value expected
+    PARSE_FIRST, ///< first element or end of container expected
+    PARSE_KEY, ///< key of object member expected
+    PARSE_KEY_STRING, ///< rest of key expected
+    PARSE_OBJECT_DIV, ///< ':' after key expected
+    PARSE_NEXT, ///< ',' or end of container expected
+} parse_state_t;
+
+struct json_parser_t {
     struct {
         char* data;
         size_t stored;
         size_t size;
     } tmp;
+    char* block;
+    json_stack_t stack;
+    size_t max_depth;
+    json_stack_t values;
+    parse_state_t state;
+    size_t checkpoint;
+    const json_sax_t* sax;
+    void* sax_data;
+    json_arena_t* arena; ///< arena for parsed values, NULL - heap
+    int views; ///< strings without escapes reference input buffer
+    /// intern table of object keys, open addressing, size is power of 2
+    struct {
+        json_t** nodes;
+        size_t size;
+        size_t count;
+        int keep; ///< keys kept between parsings
+    } keys;
+};
+
+struct json_push_parser_t {
+    json_parser_t parser;
+    struct {
+        char* data;
+        size_t size;
+        size_t capacity;
+    } carry;
+    json_t* result;
+};
+
+typedef struct reader_t {
+    json_parser_t* parser;
+    json_getc_t getc;
+    json_read_t read;
+    void* data;
+    char getc_buf;
+    size_t passed;
+    const char* begin;
+    const char* pos;
+    const char* end;
+    const char* next;
+    size_t next_len;
+    unsigned push;
+    unsigned stable; ///< input is buffer of caller, it may be referenced by views
+    unsigned terminated; ///< input is NUL terminated string, its length is found window by window
+    unsigned insitu; ///< input is mutable buffer of caller, strings are decoded in place
+    unsigned starved;
+    unsigned eof;
+    char current;
+    const char* (*spaces)(const char* pos, const char* end); ///< kernel selected for CPU, it is taken once per reader
 } reader_t;
 
+///
+///@brief Ensure that scratch buffer can store len more symbols and NUL
+/// \n Buffer grows geometrically and kept by parser between parsings
+///
+static const char* reader_reserve_s(reader_t* reader, size_t len)
+{
+    json_parser_t* parser = reader->parser;
+    if (parser->tmp.data == NULL || parser->tmp.size - parser->tmp.stored < len) {
+        size_t size = parser->tmp.size ? parser->tmp.size * 2 : PARSER_TMP_MIN_SIZE;
+        while (size - parser->tmp.stored < len) {
+            size *= 2;
+        }
+        parser->tmp.data = REALLOC(parser->tmp.data, size + 1);
+        parser->tmp.size = size;
+        log_debug_msg("increase tmp to %zu", parser->tmp.size);
+    }
+    return parser->tmp.data;
+error:
+    return NULL;
+}
+
 static const char* reader_put2s(reader_t* reader, char c)
 {
-    if (reader->tmp.stored == reader->tmp.size) {
-        reader->tmp.data = REALLOC(reader->tmp.data, reader->tmp.size + 2);
-        reader->tmp.size++;
-        log_debug_msg("increase tmp to %zu", reader->tmp.size);
+    json_parser_t* parser = reader->parser;
+    if (parser->tmp.stored == parser->tmp.size) {
+        CHECK_FUNC(reader_reserve_s(reader, 1));
     }
-    reader->tmp.data[reader->tmp.stored++] = c;
-    reader->tmp.data[reader->tmp.stored] = 0;
-    return reader->tmp.data;
+    parser->tmp.data[parser->tmp.stored++] = c;
+    parser->tmp.data[parser->tmp.stored] = 0;
+    return parser->tmp.data;
 error:
     return NULL;
 }
@@ -184,14 +350,28 @@ error:
     log_debug_msg("push:%s", symbol_str(c));                         \
     CHECK_FUNC(reader_put2s(reader, c), "symbol:%s", symbol_str(c)); \
 })
+
+static const char* reader_putn2s(reader_t* reader, const char* str, size_t len)
+{
+    json_parser_t* parser = reader->parser;
+    CHECK_FUNC(reader_reserve_s(reader, len));
+    memcpy(&parser->tmp.data[parser->tmp.stored], str, len);
+    parser->tmp.stored += len;
+    parser->tmp.data[parser->tmp.stored] = 0;
+    return parser->tmp.data;
+error:
+    return NULL;
+}
+#define READER_PUTN2S(reader, str, len) ({                       \
+    log_debug_msg("push %zu symbols", (size_t)(len));            \
+    CHECK_FUNC(reader_putn2s(reader, str, len), "len:%zu", len); \
+})
 static const char* reader_reset_s(reader_t* reader)
 {
-    if (reader->tmp.size == 0 && reader->tmp.data == NULL) {
-        reader->tmp.data = CALLOC(1, sizeof(char));
-    }
-    reader->tmp.data[0] = 0;
-    reader->tmp.stored = 0;
-    return reader->tmp.data;
+    reader->parser->tmp.stored = 0;
+    CHECK_FUNC(reader_reserve_s(reader, 0));
+    reader->parser->tmp.data[0] = 0;
+    return reader->parser->tmp.data;
 error:
     return NULL;
 }
@@ -202,36 +382,202 @@ error:
 
 static const char* reader_get_s(reader_t* reader)
 {
-    return reader->tmp.data;
+    return reader->parser->tmp.data;
+}
+
+///
+///@brief Refill reader window
+///@return count of symbols available in new window. 0 - end of input
+///
+static size_t reader_fill(reader_t* self)
+{
+    self->passed += (size_t)(self->end - self->begin);
+    if (self->read != NULL) {
+        if (self->parser->block == NULL) {
+            self->parser->block = CALLOC(READER_BLOCK_SIZE, sizeof(char));
+        }
+        size_t size = self->read(self->data, self->parser->block, READER_BLOCK_SIZE);
+        log_debug_msg("read %zu symbols", size);
+        self->begin = self->parser->block;
+        self->pos = self->begin;
+        self->end = self->begin + size;
+        return size;
+    }
+    if (self->next != NULL) {
+        size_t size = self->next_len;
+        log_debug_msg("switch to next buffer of %zu symbols", size);
+        self->begin = self->next;
+        self->pos = self->begin;
+        self->end = self->begin + size;
+        self->next = NULL;
+        if (size != 0) {
+            return size;
+        }
+    }
+    if (self->terminated && *self->end != '\0') {
+        self->begin = self->end;
+        self->pos = self->begin;
+        self->end = self->begin + strnlen(self->begin, READER_BLOCK_SIZE);
+        log_debug_msg("next window of %zu symbols", (size_t)(self->end - self->begin));
+        return (size_t)(self->end - self->begin);
+    }
+    if (self->getc == NULL) {
+        log_debug_msg("end of buffer");
+        if (self->push) {
+            log_debug_msg("input starved");
+            self->starved = 1;
+        }
+        self->begin = self->end;
+        self->pos = self->end;
+        return 0;
+    }
+    self->getc_buf = self->getc(self->data);
+    self->begin = &self->getc_buf;
+    self->pos = self->begin;
+    self->end = self->begin + 1;
+    return 1;
+error:
+    return 0;
+}
+
+static char get_c(reader_t* self)
+{
+    log_trace_func();
+    if (self->pos == self->end && reader_fill(self) == 0) {
+        self->eof = 1;
+        self->current = 0;
+    } else {
+        self->current = *self->pos++;
+    }
+    log_debug_msg("symbol:%s", symbol_str(self->current));
+    return self->current;
+}
+
+static char cur_c(reader_t* self)
+{
+    return self->current;
 }
 
-static reader_t reader_init(char (*getc)(void*), void* data)
+static reader_t reader_init(json_parser_t* parser, char (*getc)(void*), void* data)
 {
     log_trace_func();
     reader_t self;
     memset(&self, 0, sizeof(self));
+    self.parser = parser;
+    self.spaces = scan_impl()->spaces;
     self.data = data;
     self.getc = getc;
-    self.current = getc(data);
+    get_c(&self);
     return self;
 }
 
-static void reader_cleanup(reader_t* reader)
+static reader_t reader_init_read(json_parser_t* parser, json_read_t read, void* data)
 {
-    free(reader->tmp.data);
+    log_trace_func();
+    reader_t self;
+    memset(&self, 0, sizeof(self));
+    self.parser = parser;
+    self.spaces = scan_impl()->spaces;
+    self.data = data;
+    self.read = read;
+    get_c(&self);
+    return self;
 }
 
-static char get_c(reader_t* self)
+static reader_t reader_init_buf(json_parser_t* parser, const char* data, size_t len)
 {
     log_trace_func();
-    self->current = self->getc(self->data);
-    log_debug_msg("symbol:%s", symbol_str(self->current));
-    return self->current;
+    reader_t self;
+    memset(&self, 0, sizeof(self));
+    self.parser = parser;
+    self.spaces = scan_impl()->spaces;
+    self.begin = data;
+    self.pos = data;
+    self.end = data + len;
+    self.stable = 1;
+    get_c(&self);
+    return self;
 }
 
-static char cur_c(reader_t* self)
+///
+///@brief Reader of NUL terminated string, NUL is end of input
+/// \n String is taken by windows, so it is not scanned for its length before parsing
+///
+static reader_t reader_init_str(json_parser_t* parser, const char* str)
 {
-    return self->current;
+    log_trace_func();
+    reader_t self;
+    memset(&self, 0, sizeof(self));
+    self.parser = parser;
+    self.spaces = scan_impl()->spaces;
+    self.begin = str;
+    self.pos = str;
+    self.end = str + strnlen(str, READER_BLOCK_SIZE);
+    self.stable = 1;
+    self.terminated = 1;
+    get_c(&self);
+    return self;
+}
+
+///
+///@brief Reader of input pushed by parts: tail of previous part kept by parser and new part
+/// \n Reaching end of new part is not end of input, reader only marks itself as starved
+///
+static reader_t reader_init_push(json_parser_t* parser, const char* kept, size_t kept_len, const char* data, size_t len)
+{
+    log_trace_func();
+    reader_t self;
+    memset(&self, 0, sizeof(self));
+    self.parser = parser;
+    self.spaces = scan_impl()->spaces;
+    self.begin = kept_len ? kept : data;
+    self.pos = self.begin;
+    self.end = self.begin + (kept_len ? kept_len : len);
+    self.next = kept_len ? data : NULL;
+    self.next_len = len;
+    self.push = 1;
+    get_c(&self);
+    return self;
+}
+
+///
+///@brief Offset of current symbol from begin of input.
+///
+static size_t reader_tell(reader_t* self)
+{
+    return self->passed + (size_t)(self->pos - self->begin) - 1 + self->eof;
+}
+
+///
+///@brief Count of symbols taken from source.
+///
+static size_t reader_taken(reader_t* self)
+{
+    return self->passed + (size_t)(self->end - self->begin);
+}
+
+static void json_parse_keys_release(json_parser_t* parser);
+
+static void json_parser_cleanup(json_parser_t* parser)
+{
+    json_parse_keys_release(parser);
+    FREE(parser->keys.nodes);
+    parser->keys.size = 0;
+    json_stack_cleanup(&parser->stack);
+    json_stack_cleanup(&parser->values);
+    FREE(parser->block);
+    FREE(parser->tmp.data);
+    parser->tmp.size = 0;
+    parser->tmp.stored = 0;
+}
+
+static size_t json_read_file(FILE* file, char* buf, size_t size)
+{
+    size_t ret = fread(buf, sizeof(char), size, file);
+    if (ret < size && ferror(file)) {
+        log_error_msg("fread(): %s(%i)", strerror(errno), errno);
+    }
+    return ret;
 }
 
 static char json_get_c_file(FILE* file)
@@ -244,11 +590,17 @@ static char json_get_c_file(FILE* file)
     return (char)symbol;
 }
 
-static char json_get_c_str(const char** str)
+static size_t json_read_fd(const int* fd, char* buf, size_t size)
 {
-    char ret = **str;
-    (*str)++;
-    return ret;
+    ssize_t ret;
+    do {
+        ret = read(*fd, buf, size);
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0) {
+        log_error_msg("read(): %s(%i)", strerror(errno), errno);
+        return 0;
+    }
+    return (size_t)ret;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -259,7 +611,54 @@ static char json_get_c_str(const char** str)
 
 // #define json_tmp_t json_t CLEANUP(json_deinit)
 
-static json_t* json_init_from_value_internal(json_type_t type, const char* value_str);
+static json_t* json_init_from_value_internal(json_arena_t* arena, json_type_t type, const char* value_str);
+static json_t* json_init_string(json_arena_t* arena, const char* data, size_t len);
+
+///
+///@brief Allocate zero filled memory of node in arena or on heap
+///
+static void* json_alloc(json_arena_t* arena, size_t size)
+{
+    if (arena != NULL) {
+        return CHECK_FUNC(json_arena_alloc(arena, size));
+    }
+    return CALLOC(1, size);
+error:
+    return NULL;
+}
+
+///
+///@brief Allocate zero filled node in arena, in pool of thread (see json_pool_set_enabled()) or on heap
+///
+static json_t* json_node_alloc(json_arena_t* arena, size_t size)
+{
+    if (arena == NULL && json_pool_enabled()) {
+        json_t* self = json_pool_alloc(size);
+        if (self != NULL) {
+            self->in_pool = 1;
+            return self;
+        }
+    }
+    return json_alloc(arena, size);
+}
+
+static void json_node_free(json_t** self)
+{
+    if ((*self)->in_pool) {
+        json_pool_free(*self);
+        *self = NULL;
+        return;
+    }
+    FREE(*self);
+}
+
+///
+///@return arena of node, NULL for heap and static nodes
+///
+static json_arena_t* json_node_arena(const json_t* self)
+{
+    return self->in_arena ? json_arena_of(self) : NULL;
+}
 
 static const char* types_str[]
     = {
@@ -297,34 +696,239 @@ static const json_type_t* str2type(const char* type_str)
     return NULL;
 }
 
-static void json_deinit_(json_t** self)
+static int json_is_container(const json_t* self)
+{
+    return self->type == JSON_TYPE_ARRAY || self->type == JSON_TYPE_OBJECT;
+}
+
+///
+///@brief Check if value references input buffer: it is view or container with views
+/// \n Views are created by parser only and never stored into other values, so flag of
+/// container set by parser covers all its elements
+///
+static int json_has_views(const json_t* self)
+{
+    return self->is_view || self->has_views;
+}
+
+///
+///@brief NUL terminated symbols of object key
+/// \n Key decoded in place of input (see json_parser_parse_insitu()) is view terminated in input
+///
+static const char* json_key_str(const json_t* key)
+{
+    return key->is_view ? key->view.copy[0] : key->str.str;
+}
+
+#define JSON_INDEX_MIN_PAIRS 16
+
+///
+///@brief Hash index of object keys, open addressing
+/// \n Slots keep number of key/value pair + 1, so order of pairs is kept by object itself
+///
+typedef struct json_index_t {
+    size_t size; ///< count of slots, power of 2
+    unsigned slots[];
+} json_index_t;
+
+static size_t json_key_hash(const char* key, size_t* len)
+{
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    size_t id = 0;
+    for (; key[id] != '\0'; id++) {
+        hash ^= (unsigned char)key[id];
+        hash *= 0x100000001b3ULL;
+    }
+    *len = id;
+    return (size_t)hash;
+}
+
+///
+///@brief Find slot of key in index
+///@return slot with pair of key or empty slot to insert key
+///
+static unsigned* json_index_slot(const json_t* self, const json_index_t* index, const char* key)
+{
+    size_t len;
+    size_t mask = index->size - 1;
+    for (size_t id = json_key_hash(key, &len) & mask;; id = (id + 1) & mask) {
+        unsigned* slot = (unsigned*)&index->slots[id];
+        if (*slot == 0 || strcmp(json_key_str(self->arr.nodes[(*slot - 1) * 2]), key) == 0) {
+            return slot;
+        }
+    }
+}
+
+///
+///@brief Add pair into index, first of duplicated keys is kept as for linear search
+///
+static void json_index_insert(const json_t* self, json_index_t* index, unsigned pair)
+{
+    unsigned* slot = json_index_slot(self, index, json_key_str(self->arr.nodes[pair * 2]));
+    if (*slot == 0) {
+        *slot = pair + 1;
+    }
+}
+
+///
+///@brief Build index of object keys with load factor not more than 1/2
+///@return index or NULL for object below threshold or allocation error.
+/// \n Index is optimization only, object without it is searched linearly
+///
+static json_index_t* json_index_build(const json_t* self)
 {
     log_trace_func();
-    ASSERT_PPTR(self, ;);
-    log_debug_msg(JSON_FORMAT(self));
-    switch ((*self)->type) {
+    unsigned pairs = self->arr.size / 2;
+    if (pairs < JSON_INDEX_MIN_PAIRS) {
+        return NULL;
+    }
+    size_t size = JSON_INDEX_MIN_PAIRS * 2;
+    while (size < (size_t)pairs * 2) {
+        size *= 2;
+    }
+    json_index_t* index = CHECK_FUNC(json_alloc(json_node_arena(self), sizeof(json_index_t) + size * sizeof(unsigned)));
+    index->size = size;
+    for (unsigned pair = 0; pair < pairs; pair++) {
+        json_index_insert(self, index, pair);
+    }
+    log_debug_msg("index of %u keys, %zu slots", pairs, size);
+    return index;
+error:
+    return NULL;
+}
+
+static json_index_t* json_index_copy(json_arena_t* arena, const json_index_t* index)
+{
+    log_trace_func();
+    if (index == NULL) {
+        return NULL;
+    }
+    size_t size = sizeof(json_index_t) + index->size * sizeof(unsigned);
+    json_index_t* new = CHECK_FUNC(json_alloc(arena, size));
+    memcpy(new, index, size);
+    return new;
+error:
+    return NULL;
+}
+
+///
+///@brief Update index after pair appended to object
+///
+static void json_index_append(json_t* self)
+{
+    log_trace_func();
+    json_index_t* index = self->arr.index;
+    unsigned pairs = self->arr.size / 2;
+    if (index != NULL && (size_t)pairs * 2 <= index->size) {
+        json_index_insert(self, index, pairs - 1);
+        return;
+    }
+    if (!self->in_arena) {
+        FREE(self->arr.index);
+    }
+    self->arr.index = json_index_build(self);
+}
+
+///
+///@brief Find pair of key in object
+///@return number of pair or -1 if key not found
+///
+static ssize_t json_object_find(const json_t* self, const char* key)
+{
+    if (self->arr.index != NULL) {
+        unsigned slot = *json_index_slot(self, self->arr.index, key);
+        return (ssize_t)slot - 1;
+    }
+    for (size_t id = 0; id < self->arr.size; id += 2) {
+        if (strcmp(key, json_key_str(self->arr.nodes[id])) == 0) {
+            return (ssize_t)(id / 2);
+        }
+    }
+    return -1;
+}
+
+///
+///@brief Release node without children
+/// \n Reference of container is dropped by caller, its children are released already
+///
+static void json_release(json_t* self)
+{
+    log_trace_func();
+    log_debug_msg(JSON_FORMAT(&self));
+    if (self->in_arena) {
+        log_debug_msg("node of arena: deinit not required");
+        return;
+    }
+    switch (self->type) {
     case JSON_TYPE_NULL:
     case JSON_TYPE_FALSE:
     case JSON_TYPE_TRUE:
-        log_debug_msg("base type %s: deinit not required", type2str((*self)->type));
-        *self = NULL;
+        log_debug_msg("base type %s: deinit not required", type2str(self->type));
         return;
     case JSON_TYPE_STRING:
     case JSON_TYPE_NUMBER:
-        if ((*self)->str.refcnt > 1) {
-            (*self)->str.refcnt--;
-            log_debug_msg("refcnt: %zu", (*self)->str.refcnt);
+        if (REFCNT_DEC(self->str.refcnt) != 0) {
+            log_debug_msg("refcnt decreased");
             return;
         }
+        if (self->is_view && self->view.copy[0] != self->view.data) {
+            FREE(self->view.copy[0]);
+        }
+        break;
+    case JSON_TYPE_OBJECT:
+        FREE(self->arr.index);
         break;
     default:
-        for (size_t id = 0; id < (*self)->arr.size; id++) {
-            log_debug_msg("deinit: %p", (*self)->arr.nodes[id]);
-            json_deinit_(&((*self)->arr.nodes[id]));
-        }
         break;
     }
-    FREE_PTR(self);
+    json_node_free(&self);
+}
+
+///
+///@brief Drop reference to node, release it with all children not shared by other references
+/// \n Works without recursion and allocation: slot of container released last is used
+/// to store pointer to parent container
+///
+static void json_deinit_(json_t** self)
+{
+    log_trace_func();
+    json_t* node = ASSERT_PPTR(self, ;);
+    json_t* parent = NULL;
+    *self = NULL;
+    if (node->in_arena) {
+        log_debug_msg("node of arena: deinit not required");
+        return;
+    }
+    if (!json_is_container(node)) {
+        json_release(node);
+        return;
+    }
+    if (REFCNT_DEC(node->arr.refcnt) != 0) {
+        log_debug_msg("container is shared: refcnt decreased");
+        return;
+    }
+    for (;;) {
+        if (node->arr.size > 0) {
+            json_t* child = node->arr.nodes[node->arr.size - 1];
+            node->arr.size--;
+            if (!json_is_container(child)) {
+                json_release(child);
+            } else if (REFCNT_DEC(child->arr.refcnt) == 0) {
+                log_debug_msg("deinit children of %p", child);
+                node->arr.nodes[node->arr.size] = parent;
+                parent = node;
+                node = child;
+            }
+            continue;
+        }
+        json_release(node);
+        if (parent == NULL) {
+            return;
+        }
+        node = parent;
+        parent = node->arr.nodes[node->arr.size];
+    }
 }
 
 void json_deinit(json_t** self)
@@ -340,62 +944,228 @@ void json_deinit(json_t** self)
     return;
 }
 
-json_t* json_copy(json_t** self)
+typedef struct json_copy_frame_t {
+    json_t* source;
+    json_t* target;
+} json_copy_frame_t;
+
+///
+///@brief Copy node into arena or heap. Containers copied without children
+/// \n Strings and numbers are shared inside heap or the same arena, otherwise duplicated.
+/// Views are always duplicated.
+///
+static json_t* json_copy_node(json_t* self, json_arena_t* arena)
 {
     log_trace_func();
+    log_debug_msg(JSON_FORMAT(&self));
     json_t* new = NULL;
-    ASSERT_PPTR(self);
-    log_debug_msg(JSON_FORMAT(self));
-    switch ((*self)->type) {
+    switch (self->type) {
     case JSON_TYPE_NULL:
     case JSON_TYPE_TRUE:
     case JSON_TYPE_FALSE:
-        return *self;
+        // copy is not stored yet, rooted twin is replaced by node of user
+        return json_init_from_value_internal(arena, self->type, NULL);
     case JSON_TYPE_STRING:
     case JSON_TYPE_NUMBER:
-        ((*self))->str.refcnt++;
-        return *self;
+        if (self->is_view) {
+            // copy may outlive input buffer
+            return json_init_string(arena, self->view.data, self->view.len);
+        }
+        if (json_node_arena(self) != arena) {
+            return json_init_from_value_internal(arena, self->type, self->type == JSON_TYPE_NUMBER ? self->num.str : self->str.str);
+        }
+        if (!self->in_arena) {
+            REFCNT_INC(self->str.refcnt);
+        }
+        return self;
     default:
         break;
     }
-    new = CALLOC(1, (*self)->arr.size * sizeof(typeof((*self)->arr.nodes[0])) + sizeof(json_t));
-    *new = **self;
-    new->have_root = 0;
-    for (size_t i = 0; i < (*self)->arr.size; i++) {
-        new->arr.nodes[i] = CHECK_FUNC(json_copy(&(*self)->arr.nodes[i]));
-        new->arr.nodes[i]->have_root = 1;
-    }
-    log_debug_msg(JSON_FORMAT(&new));
+    new = CHECK_FUNC(json_node_alloc(arena, self->arr.size * sizeof(typeof(self->arr.nodes[0])) + sizeof(json_t)));
+    // counter of self may be changed by other owners, so header is not copied as whole
+    new->type = self->type;
+    new->in_arena = arena != NULL;
+    new->capacity = self->arr.size;
+    new->arr.refcnt = 1;
+    new->arr.index = json_index_copy(arena, self->arr.index);
     return new;
 error:
-    json_deinit(&new);
     return NULL;
 }
 
-static void json_set_f(json_t** self, json_t** elem, size_t id)
+///
+///@brief Deep copy of value into arena or heap
+///
+static json_t* json_copy_to(json_t** self, json_arena_t* arena)
 {
     log_trace_func();
+    json_t* new = NULL;
+    json_stack_t stack;
+    memset(&stack, 0, sizeof(stack));
     log_debug_msg(JSON_FORMAT(self));
-    log_debug_msg(JSON_FORMAT(elem));
-    log_debug_msg("id:%zu", id);
-    json_t* old = (*self)->arr.nodes[id];
-    log_debug_msg("deinit:" JSON_FORMAT(&old));
-    (*self)->arr.nodes[id] = *elem;
-    (*self)->arr.nodes[id]->have_root = 1;
-    json_deinit_(&old);
-}
-
-const char* json_get_type(json_t** self)
-{
-    ASSERT_PPTR(self);
-    return type2str((*self)->type);
+    new = CHECK_FUNC(json_copy_node(*self, arena));
+    if (json_is_container(new)) {
+        json_copy_frame_t* frame = CHECK_FUNC(STACK_PUSH(&stack, json_copy_frame_t));
+        frame->source = *self;
+        frame->target = new;
+    }
+    for (json_copy_frame_t* frame; (frame = STACK_TOP(&stack, json_copy_frame_t)) != NULL;) {
+        if (frame->target->arr.size == frame->source->arr.size) {
+            STACK_POP(&stack, json_copy_frame_t);
+            continue;
+        }
+        json_t* source = frame->source->arr.nodes[frame->target->arr.size];
+        // shared strings and numbers are rooted already, they may be read by other threads
+        json_t* target = json_node_stored(CHECK_FUNC(json_copy_node(source, arena)));
+        frame->target->arr.nodes[frame->target->arr.size++] = target;
+        if (json_is_container(target)) {
+            frame = CHECK_FUNC(STACK_PUSH(&stack, json_copy_frame_t));
+            frame->source = source;
+            frame->target = target;
+        }
+    }
+    log_debug_msg(JSON_FORMAT(&new));
+    json_stack_cleanup(&stack);
+    return new;
+error:
+    json_stack_cleanup(&stack);
+    json_deinit(&new);
     return NULL;
 }
 
-const char* json_get_str(json_t** self)
+///
+///@brief Take one more reference to node of heap
+///
+static json_t* json_share(json_t* self)
 {
-    log_trace_func();
-    ASSERT_PPTR(self);
+    switch (self->type) {
+    case JSON_TYPE_STRING:
+    case JSON_TYPE_NUMBER:
+        REFCNT_INC(self->str.refcnt);
+        break;
+    case JSON_TYPE_ARRAY:
+    case JSON_TYPE_OBJECT:
+        REFCNT_INC(self->arr.refcnt);
+        break;
+    default:
+        break;
+    }
+    return self;
+}
+
+///
+///@brief Copy node of heap, children of container are shared by copy and self
+/// \n Strings and numbers are duplicated: shared node keeps root flag of self
+///
+static json_t* json_copy_shallow(json_t* self)
+{
+    log_trace_func();
+    log_debug_msg(JSON_FORMAT(&self));
+    if (!json_is_container(self)) {
+        if (self->is_view || (self->type != JSON_TYPE_STRING && self->type != JSON_TYPE_NUMBER)) {
+            return json_copy_node(self, NULL);
+        }
+        return json_init_from_value_internal(NULL, self->type, self->type == JSON_TYPE_NUMBER ? self->num.str : self->str.str);
+    }
+    json_t* new = CHECK_FUNC(json_copy_node(self, NULL));
+    new->has_views = self->has_views;
+    for (; new->arr.size < self->arr.size; new->arr.size++) {
+        new->arr.nodes[new->arr.size] = json_share(self->arr.nodes[new->arr.size]);
+    }
+    return new;
+error:
+    return NULL;
+}
+
+///
+///@brief Make container stored in self owned by self only before its slots are given or changed
+/// \n Container shared by copies is replaced by its shallow copy, so changes of value
+/// copy only containers on path to changed node
+///@return container stored in self. NULL in case of error, self is not changed
+///
+static json_t* json_unshare(json_t** self)
+{
+    log_trace_func();
+    if ((*self)->in_arena || json_refcnt(*self) == 1) {
+        return *self;
+    }
+    log_debug_msg("copy shared " JSON_FORMAT(self));
+    json_t* old = *self;
+    json_t* new = CHECK_FUNC(json_copy_shallow(old));
+    new->have_root = old->have_root;
+    *self = new;
+    json_deinit_(&old);
+    return new;
+error:
+    return NULL;
+}
+
+json_t* json_copy(json_t** self)
+{
+    log_trace_func();
+    ASSERT_PPTR(self);
+    return json_copy_to(self, NULL);
+}
+
+json_t* json_copy_shared(json_t** self)
+{
+    log_trace_func();
+    ASSERT_PPTR(self);
+    if ((*self)->in_arena || json_has_views(*self)) {
+        // copy of views may outlive input buffer
+        return json_copy_to(self, NULL);
+    }
+    log_debug_msg("share children of " JSON_FORMAT(self));
+    return json_copy_shallow(*self);
+}
+
+static void json_set_f(json_t** self, json_t** elem, size_t id)
+{
+    log_trace_func();
+    log_debug_msg(JSON_FORMAT(self));
+    log_debug_msg(JSON_FORMAT(elem));
+    log_debug_msg("id:%zu", id);
+    json_t* old = (*self)->arr.nodes[id];
+    log_debug_msg("deinit:" JSON_FORMAT(&old));
+    (*self)->arr.nodes[id] = json_node_stored(*elem);
+    json_deinit_(&old);
+}
+
+const char* json_get_type(json_t** self)
+{
+    ASSERT_PPTR(self);
+    return type2str((*self)->type);
+    return NULL;
+}
+
+///
+///@brief NUL terminated symbols of view, copy is made by the first call and kept in node
+///
+static const char* json_view_str(json_t* self)
+{
+    log_trace_func();
+    char* copy = __atomic_load_n(&self->view.copy[0], __ATOMIC_ACQUIRE);
+    if (copy == NULL) {
+        char* expected = NULL;
+        copy = CHECK_FUNC(json_alloc(json_node_arena(self), self->view.len + 1));
+        memcpy(copy, self->view.data, self->view.len);
+        // node may be shared by threads, copy of the first one is kept
+        if (!__atomic_compare_exchange_n(&self->view.copy[0], &expected, copy, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            if (!self->in_arena) {
+                FREE(copy);
+            }
+            copy = expected;
+        }
+    }
+    return copy;
+error:
+    return NULL;
+}
+
+const char* json_get_str(json_t** self)
+{
+    log_trace_func();
+    ASSERT_PPTR(self);
     log_debug_msg(JSON_FORMAT(self));
     switch ((*self)->type) {
     case JSON_TYPE_NULL:
@@ -403,8 +1173,9 @@ const char* json_get_str(json_t** self)
     case JSON_TYPE_FALSE:
         return type2str((*self)->type);
     case JSON_TYPE_NUMBER:
+        return (*self)->num.str;
     case JSON_TYPE_STRING:
-        return (*self)->str.str;
+        return (*self)->is_view ? json_view_str(*self) : (*self)->str.str;
     default:
         log_error_msg("not supported for %s type", type2str((*self)->type));
         break;
@@ -412,6 +1183,83 @@ const char* json_get_str(json_t** self)
     return NULL;
 }
 
+const char* json_get_strn(json_t** self, size_t* len)
+{
+    log_trace_func();
+    ASSERT_PPTR(self);
+    ASSERT_NULL(len);
+    log_debug_msg(JSON_FORMAT(self));
+    const char* str = NULL;
+    switch ((*self)->type) {
+    case JSON_TYPE_NULL:
+    case JSON_TYPE_TRUE:
+    case JSON_TYPE_FALSE:
+        str = type2str((*self)->type);
+        break;
+    case JSON_TYPE_NUMBER:
+        str = (*self)->num.str;
+        break;
+    case JSON_TYPE_STRING:
+        if ((*self)->is_view) {
+            *len = (*self)->view.len;
+            return (*self)->view.data;
+        }
+        str = (*self)->str.str;
+        break;
+    default:
+        log_error_msg("not supported for %s type", type2str((*self)->type));
+        return NULL;
+    }
+    *len = strlen(str);
+    return str;
+}
+
+int json_get_int64(json_t** self, int64_t* value)
+{
+    log_trace_func();
+    ASSERT_PPTR(self, -1);
+    ASSERT_NULL(value, -1);
+    log_debug_msg(JSON_FORMAT(self));
+    if ((*self)->type != JSON_TYPE_NUMBER) {
+        log_error_msg("not supported for %s type", type2str((*self)->type));
+        return -1;
+    }
+    if ((*self)->num.is_int) {
+        *value = (*self)->num.i;
+        return 0;
+    }
+    double d = (*self)->num.d;
+    // -2^63 excluded too: texts beyond int64 (e.g. -9223372036854775809) are rounded to it
+    if (d > -0x1p63 && d < 0x1p63 && d == (double)(int64_t)d) {
+        *value = (int64_t)d;
+        return 0;
+    }
+    log_error_msg("'%s' is not int64", (*self)->num.str);
+    return -1;
+}
+
+int json_get_double(json_t** self, double* value)
+{
+    log_trace_func();
+    ASSERT_PPTR(self, -1);
+    ASSERT_NULL(value, -1);
+    log_debug_msg(JSON_FORMAT(self));
+    if ((*self)->type != JSON_TYPE_NUMBER) {
+        log_error_msg("not supported for %s type", type2str((*self)->type));
+        return -1;
+    }
+    if ((*self)->num.is_int) {
+        *value = (double)(*self)->num.i;
+        return 0;
+    }
+    if (isinf((*self)->num.d)) {
+        log_error_msg("'%s' is out of double range", (*self)->num.str);
+        return -1;
+    }
+    *value = (*self)->num.d;
+    return 0;
+}
+
 size_t json_size(json_t** self)
 {
     ASSERT_PPTR(self, 0);
@@ -457,6 +1305,16 @@ error:
     return NULL;
 }
 
+json_t** json_get_mut_by_id(json_t** self, size_t id)
+{
+    log_trace_func();
+    json_t** slot = CHECK_FUNC(json_get_by_id(self, id));
+    size_t pos = (size_t)(slot - (*self)->arr.nodes);
+    return &CHECK_FUNC(json_unshare(self))->arr.nodes[pos];
+error:
+    return NULL;
+}
+
 const char* json_key(json_t** self, size_t id)
 {
     log_trace_func();
@@ -466,7 +1324,7 @@ const char* json_key(json_t** self, size_t id)
     switch ((*self)->type) {
     case JSON_TYPE_OBJECT:
         id = id * 2;
-        return (*CHECK_FUNC(json_get_by_id_(self, id)))->str.str;
+        return json_key_str(*CHECK_FUNC(json_get_by_id_(self, id)));
     default:
         log_error_msg("not supported for %s type", type2str((*self)->type));
         break;
@@ -483,14 +1341,14 @@ json_t** json_get_by_key(json_t** self, const char* key)
     log_debug_msg(JSON_FORMAT(self));
     log_debug_msg("key:%s", key);
     switch ((*self)->type) {
-    case JSON_TYPE_OBJECT:
-        for (size_t i = 0; i < (*self)->arr.size; i += 2) {
-            if (strcmp(key, (*self)->arr.nodes[i]->str.str) == 0) {
-                return &((*self)->arr.nodes[i + 1]);
-            }
+    case JSON_TYPE_OBJECT: {
+        ssize_t pair = json_object_find(*self, key);
+        if (pair >= 0) {
+            return &((*self)->arr.nodes[pair * 2 + 1]);
         }
         log_error_msg("key '%s' not fround", key);
         goto error;
+    }
     default:
         log_error_msg("not supported for %s type", type2str((*self)->type));
         break;
@@ -499,41 +1357,102 @@ error:
     return NULL;
 }
 
-static json_t** json_check_circular_ref(json_t** self, json_t** elem)
+json_t** json_get_mut_by_key(json_t** self, const char* key)
+{
+    log_trace_func();
+    json_t** slot = CHECK_FUNC(json_get_by_key(self, key));
+    size_t pos = (size_t)(slot - (*self)->arr.nodes);
+    return &CHECK_FUNC(json_unshare(self))->arr.nodes[pos];
+error:
+    return NULL;
+}
+
+typedef struct json_walk_frame_t {
+    json_t* node;
+    size_t id;
+} json_walk_frame_t;
+
+///
+///@brief Check that self is reachable from elem
+///@return 1 - circular reference found, 0 - not found, -1 - error
+///
+static int json_check_circular_ref(json_t** self, json_t** elem)
 {
     log_trace_func();
     log_debug_msg(JSON_FORMAT(self));
     log_debug_msg(JSON_FORMAT(elem));
-    switch ((*elem)->type) {
-    case JSON_TYPE_ARRAY:
-    case JSON_TYPE_OBJECT: {
-        if (*elem == *self) {
+    int ret = -1;
+    json_stack_t stack;
+    memset(&stack, 0, sizeof(stack));
+    if (json_is_container(*elem)) {
+        json_walk_frame_t* frame = CHECK_FUNC(STACK_PUSH(&stack, json_walk_frame_t));
+        frame->node = *elem;
+        frame->id = 0;
+    }
+    for (json_walk_frame_t* frame; (frame = STACK_TOP(&stack, json_walk_frame_t)) != NULL;) {
+        if (frame->node == *self) {
             log_debug_msg("circular ref found!");
-            return NULL;
+            ret = 1;
+            goto error;
         }
-        for (size_t id = 0; id < (*elem)->arr.size; id++) {
-            if (json_check_circular_ref(self, &((*elem)->arr.nodes[id])) == NULL) {
-                log_debug_msg("Found circular ref");
-                return NULL;
-            }
+        if (frame->id == frame->node->arr.size) {
+            STACK_POP(&stack, json_walk_frame_t);
+            continue;
+        }
+        json_t* child = frame->node->arr.nodes[frame->id++];
+        if (json_is_container(child)) {
+            frame = CHECK_FUNC(STACK_PUSH(&stack, json_walk_frame_t));
+            frame->node = child;
+            frame->id = 0;
         }
-        break;
-    }
-    default:
-        break;
     }
-    return elem;
+    ret = 0;
+error:
+    json_stack_cleanup(&stack);
+    return ret;
 }
-static json_t* json_elem_copy(json_t** self, json_t** elem, int check_circular)
+///
+///@brief Prepare element to be stored in self
+///@param moved [out] 1 - element owned by user is copied into arena or heap of self,
+/// it should be released when stored
+///
+static json_t* json_elem_copy(json_t** self, json_t** elem, int check_circular, int* moved)
 {
     log_trace_func();
     log_debug_msg(JSON_FORMAT(self));
     log_debug_msg(JSON_FORMAT(elem));
     log_debug_msg("check_circular:%s", check_circular ? JSON_TRUE : JSON_FALSE);
     log_debug_msg("have_root:%s", (*self)->have_root ? JSON_TRUE : JSON_FALSE);
-    if ((*elem)->have_root || (check_circular && (json_check_circular_ref(self, elem) == NULL))) {
+    json_arena_t* arena = json_node_arena(*self);
+    *moved = 0;
+    int circular = check_circular ? json_check_circular_ref(self, elem) : 0;
+    if (circular < 0) {
+        log_error_msg("can't check circular reference");
+        return NULL;
+    }
+    if (json_has_views(*elem)) {
+        // container of elem does not track views, so they are not stored
+        log_debug_msg("copy elem referencing input buffer");
+        json_t* new = CHECK_FUNC(json_copy_to(elem, arena));
+        *moved = !(*elem)->have_root;
+        return new;
+    }
+    int in_heap = arena == NULL && !(*elem)->in_arena;
+    if ((*elem)->have_root || circular) {
         log_debug_msg("copy elem");
-        return CHECK_FUNC(json_copy(elem));
+        return CHECK_FUNC(json_copy_to(elem, arena));
+    }
+    if (json_node_arena(*elem) != arena) {
+        log_debug_msg("move elem to %p arena", arena);
+        json_t* new = CHECK_FUNC(json_copy_to(elem, arena));
+        *moved = new != *elem;
+        return new;
+    }
+    if (in_heap && json_refcnt(*elem) > 1) {
+        // other references of user should not see elem rooted and changed
+        log_debug_msg("move elem shared by copies");
+        *moved = 1;
+        return CHECK_FUNC(json_copy_shallow(*elem));
     }
     log_debug_msg("not copy elem");
     return *elem;
@@ -541,6 +1460,71 @@ error:
     return NULL;
 }
 
+///
+///@brief Release element moved into other memory and point it to new place
+///
+static void json_elem_moved(json_t** elem, json_t* new_elem, int moved)
+{
+    if (moved) {
+        json_t* old = *elem;
+        *elem = new_elem;
+        json_deinit_(&old);
+    }
+}
+
+#define CONTAINER_MIN_CAPACITY 4
+
+///
+///@brief Set capacity of container, container of arena is copied to new place of arena
+/// \n Container of pool is moved to block of other class when it does not fit its block
+///@param capacity count of nodes, not less than size of container
+///@return new place of container stored in self. NULL in case of error, self is not changed
+///
+static json_t* json_container_resize(json_t** self, size_t capacity)
+{
+    log_trace_func();
+    log_debug_msg("capacity %u -> %zu", (*self)->capacity, capacity);
+    if (capacity > UINT_MAX) {
+        log_error_msg("capacity %zu is too big", capacity);
+        return NULL;
+    }
+    size_t bytes = capacity * sizeof(typeof((*self)->arr.nodes[0])) + sizeof(json_t);
+    size_t used = (*self)->arr.size * sizeof(typeof((*self)->arr.nodes[0])) + sizeof(json_t);
+    if ((*self)->in_pool) {
+        if (json_pool_block_size(*self) < bytes) {
+            json_t* new = CHECK_FUNC(json_node_alloc(NULL, bytes));
+            unsigned in_pool = new->in_pool;
+            memcpy(new, *self, used);
+            new->in_pool = in_pool ? 1 : 0;
+            json_node_free(self);
+            *self = new;
+        }
+    } else if (!(*self)->in_arena) {
+        *self = REALLOC((*self), bytes);
+    } else {
+        json_t* new = CHECK_FUNC(json_arena_alloc(json_arena_of(*self), bytes));
+        memcpy(new, *self, used);
+        *self = new;
+    }
+    (*self)->capacity = (unsigned)capacity;
+    return *self;
+error:
+    return NULL;
+}
+
+///
+///@brief Make room for size nodes in container, capacity grows geometrically
+/// so appending of n nodes costs O(n) copying
+///
+static json_t* json_container_grow(json_t** self, size_t size)
+{
+    if (size <= (*self)->capacity) {
+        return *self;
+    }
+    size_t capacity = (*self)->capacity < CONTAINER_MIN_CAPACITY / 2 ? CONTAINER_MIN_CAPACITY : (size_t)(*self)->capacity * 2;
+    return json_container_resize(self, capacity < size ? size : capacity);
+}
+
 static json_t** json_set_by_id_(json_t** self, json_t** elem, size_t id, int check_circular)
 {
     log_trace_func();
@@ -548,14 +1532,17 @@ static json_t** json_set_by_id_(json_t** self, json_t** elem, size_t id, int che
     log_debug_msg(JSON_FORMAT(elem));
     log_debug_msg("id:%zu", id);
     json_t* new_elem = NULL;
-    new_elem = CHECK_FUNC(json_elem_copy(self, elem, check_circular));
+    int moved = 0;
+    new_elem = CHECK_FUNC(json_elem_copy(self, elem, check_circular, &moved));
     log_debug_msg(JSON_FORMAT(elem));
+    CHECK_FUNC(json_unshare(self));
     if (id == (*self)->arr.size) {
         log_debug_msg("increase array size to %zu", (*self)->arr.size + 1);
-        (*self) = REALLOC((*self), ((*self)->arr.size + 1) * sizeof(typeof((*self)->arr.nodes[0])) + sizeof(json_t));
-        (*self)->arr.nodes[(*self)->arr.size++] = &node_null;
+        CHECK_FUNC(json_container_grow(self, (*self)->arr.size + 1));
+        (*self)->arr.nodes[(*self)->arr.size++] = &stored_null;
     }
     json_set_f(self, &new_elem, id);
+    json_elem_moved(elem, new_elem, moved);
     log_debug_msg(JSON_FORMAT(self));
     log_debug_msg(JSON_FORMAT(elem));
     return self;
@@ -609,6 +1596,7 @@ json_t** json_set_by_key(json_t** self, json_t** elem, const char* key)
     ASSERT_PPTR(elem);
     json_t* new_key = NULL;
     json_t* new_elem = NULL;
+    int moved = 0;
     log_debug_msg(JSON_FORMAT(self));
     log_debug_msg(JSON_FORMAT(elem));
     log_debug_msg("key:'%s'", key);
@@ -620,20 +1608,22 @@ json_t** json_set_by_key(json_t** self, json_t** elem, const char* key)
         log_error_msg("not supported for %s type", type2str((*self)->type));
         return NULL;
     }
-    for (size_t id = 0; id < (*self)->arr.size; id += 2) {
-        if (strcmp(key, (*self)->arr.nodes[id]->str.str) == 0) {
-            log_debug_msg("found key:'%s' in id %u", key, id / 2);
-            return CHECK_FUNC(json_set_by_id_(self, elem, id + 1, 1));
-        }
+    ssize_t pair = json_object_find(*self, key);
+    if (pair >= 0) {
+        log_debug_msg("found key:'%s' in id %zi", key, pair);
+        return CHECK_FUNC(json_set_by_id_(self, elem, (size_t)pair * 2 + 1, 1));
     }
     log_debug_msg("Add new key:'%s' for id %u", key, ((*self)->arr.size + 1) / 2);
-    new_key = CHECK_FUNC(json_init_from_value_internal(JSON_TYPE_STRING, key));
-    new_elem = CHECK_FUNC(json_elem_copy(self, elem, 1));
-    *self = REALLOC((*self), ((*self)->arr.size + 2) * sizeof(typeof((*self)->arr.nodes[0])) + sizeof(json_t));
-    (*self)->arr.nodes[(*self)->arr.size++] = &node_null;
-    (*self)->arr.nodes[(*self)->arr.size++] = &node_null;
+    new_key = CHECK_FUNC(json_init_from_value_internal(json_node_arena(*self), JSON_TYPE_STRING, key));
+    new_elem = CHECK_FUNC(json_elem_copy(self, elem, 1, &moved));
+    CHECK_FUNC(json_unshare(self));
+    CHECK_FUNC(json_container_grow(self, (*self)->arr.size + 2));
+    (*self)->arr.nodes[(*self)->arr.size++] = &stored_null;
+    (*self)->arr.nodes[(*self)->arr.size++] = &stored_null;
     json_set_f(self, &new_key, (*self)->arr.size - 2);
     json_set_f(self, &new_elem, (*self)->arr.size - 1);
+    json_elem_moved(elem, new_elem, moved);
+    json_index_append(*self);
     return self;
 error:
     json_deinit(&new_key);
@@ -650,16 +1640,160 @@ json_t** json_set(json_t** self, json_t** elem)
     ASSERT_PPTR(elem);
     unsigned have_root = (*self)->have_root;
     json_t* old = *self;
-    *self = CHECK_FUNC(json_elem_copy(self, elem, 1));
+    int moved = 0;
+    json_t* new_elem = CHECK_FUNC(json_elem_copy(self, elem, 1, &moved));
+    *self = have_root ? json_node_stored(new_elem) : new_elem;
     json_deinit_(&old);
-    (*self)->have_root = have_root ? 1 : 0;
+    json_elem_moved(elem, new_elem, moved);
+
+    return self;
+error:
+    return NULL;
+}
+
+///
+///@return count of nodes of container for count of its elements
+///
+static size_t json_container_nodes(json_t** self, size_t count)
+{
+    switch ((*self)->type) {
+    case JSON_TYPE_OBJECT:
+        if (count > SIZE_MAX / 2) {
+            log_error_msg("capacity %zu is too big", count);
+            break;
+        }
+        return count * 2;
+    case JSON_TYPE_ARRAY:
+        return count;
+    default:
+        log_error_msg("not supported for %s type", type2str((*self)->type));
+        break;
+    }
+    return SIZE_MAX;
+}
+
+json_t** json_reserve(json_t** self, size_t capacity)
+{
+    log_trace_func();
+    ASSERT_PPTR(self);
+    log_debug_msg(JSON_FORMAT(self));
+    log_debug_msg("capacity:%zu", capacity);
+    size_t nodes = json_container_nodes(self, capacity);
+    if (nodes == SIZE_MAX) {
+        return NULL;
+    }
+    CHECK_FUNC(json_unshare(self));
+    if (nodes > (*self)->capacity) {
+        CHECK_FUNC(json_container_resize(self, nodes));
+    }
+    return self;
+error:
+    return NULL;
+}
 
+json_t** json_shrink_to_fit(json_t** self)
+{
+    log_trace_func();
+    ASSERT_PPTR(self);
+    log_debug_msg(JSON_FORMAT(self));
+    if (json_container_nodes(self, 0) == SIZE_MAX) {
+        return NULL;
+    }
+    CHECK_FUNC(json_unshare(self));
+    if ((*self)->capacity > (*self)->arr.size && !(*self)->in_arena) {
+        CHECK_FUNC(json_container_resize(self, (*self)->arr.size));
+    }
     return self;
 error:
     return NULL;
 }
 
-static json_t* json_init_from_value_internal(json_type_t type, const char* value_str)
+///
+///@brief Powers of 10 represented by double exactly
+///
+static const double pow10_exact[] = {
+    1e0d, 1e1d, 1e2d, 1e3d, 1e4d, 1e5d, 1e6d, 1e7d, 1e8d, 1e9d, 1e10d, 1e11d,
+    1e12d, 1e13d, 1e14d, 1e15d, 1e16d, 1e17d, 1e18d, 1e19d, 1e20d, 1e21d, 1e22d
+};
+
+///
+///@brief "C" locale for strtod_l(), JSON numbers do not depend on LC_NUMERIC of application
+///
+static locale_t c_locale = (locale_t)0;
+
+__attribute__((constructor)) static void json_c_locale_init(void)
+{
+    c_locale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+}
+
+__attribute__((destructor)) static void json_c_locale_cleanup(void)
+{
+    if (c_locale != (locale_t)0) {
+        freelocale(c_locale);
+    }
+}
+
+///
+///@brief Calculate binary value of number node from its valid text
+/// \n Integers fitting int64 kept as int. For others exact fast path is used
+/// when both decimal mantissa and power of 10 are exact doubles, strtod_l() in "C" locale otherwise.
+///
+static void json_number_convert(json_t* self)
+{
+    log_trace_func();
+    const char* str = self->num.str;
+    int negative = *str == '-';
+    str += negative;
+    uint64_t mantissa = 0;
+    long exp10 = 0;
+    int truncated = 0;
+    int is_int = 1;
+    for (; *str >= '0' && *str <= '9'; str++) {
+        if (mantissa > (UINT64_MAX - 9) / 10) {
+            truncated = 1;
+        } else {
+            mantissa = mantissa * 10 + (uint64_t)(*str - '0');
+        }
+    }
+    if (*str == '.') {
+        is_int = 0;
+        for (str++; *str >= '0' && *str <= '9'; str++) {
+            if (mantissa > (UINT64_MAX - 9) / 10) {
+                truncated = 1;
+            } else {
+                mantissa = mantissa * 10 + (uint64_t)(*str - '0');
+                exp10--;
+            }
+        }
+    }
+    if (*str == 'e' || *str == 'E') {
+        is_int = 0;
+        str++;
+        int exp_negative = *str == '-';
+        str += *str == '-' || *str == '+';
+        long exp = 0;
+        for (; *str >= '0' && *str <= '9'; str++) {
+            exp = exp < 100000 ? exp * 10 + (*str - '0') : exp;
+        }
+        exp10 += exp_negative ? -exp : exp;
+    }
+    if (is_int && !truncated && mantissa != 0 && mantissa <= (uint64_t)INT64_MAX + (uint64_t)negative) {
+        self->num.is_int = 1;
+        self->num.i = negative ? (int64_t)(0 - mantissa) : (int64_t)mantissa;
+    } else if (is_int && !truncated && mantissa == 0 && !negative) {
+        self->num.is_int = 1;
+        self->num.i = 0;
+    } else if (!truncated && mantissa <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22) {
+        double value = (double)mantissa;
+        value = exp10 < 0 ? value / pow10_exact[-exp10] : value * pow10_exact[exp10];
+        self->num.d = negative ? -value : value;
+    } else {
+        self->num.d = c_locale != (locale_t)0 ? strtod_l(self->num.str, NULL, c_locale) : strtod(self->num.str, NULL);
+    }
+    log_debug_msg("'%s' is_int:%u", self->num.str, self->num.is_int);
+}
+
+static json_t* json_init_from_value_internal(json_arena_t* arena, json_type_t type, const char* value_str)
 {
     log_trace_func();
     log_debug_msg("type:%s", type2str(type));
@@ -672,48 +1806,115 @@ static json_t* json_init_from_value_internal(json_type_t type, const char* value
     case JSON_TYPE_TRUE:
         return (json_t*)&node_true;
     case JSON_TYPE_NUMBER:
-    case JSON_TYPE_STRING:
-        self = CALLOC(1, sizeof(json_str_t) + strlen(value_str) + 1);
+        self = CHECK_FUNC(json_node_alloc(arena, offsetof(json_t, num.str) + strlen(value_str) + 1));
         self->type = type;
-        strcpy(self->str.str, value_str);
-        self->str.refcnt = 1;
+        strcpy(self->num.str, value_str);
+        self->num.refcnt = 1;
+        json_number_convert(self);
         break;
+    case JSON_TYPE_STRING:
+        return json_init_string(arena, value_str, strlen(value_str));
     default:
-        self = CALLOC(1, sizeof(json_t));
+        self = CHECK_FUNC(json_node_alloc(arena, sizeof(json_t)));
         self->type = type;
+        self->arr.refcnt = 1;
         break;
     }
+    self->in_arena = arena != NULL;
     return self;
 error:
     return NULL;
 }
 
-static const char* parse_number(reader_t* reader);
+///
+///@brief Create string node from len symbols of data
+///
+static json_t* json_init_string(json_arena_t* arena, const char* data, size_t len)
+{
+    log_trace_func();
+    json_t* self = CHECK_FUNC(json_node_alloc(arena, offsetof(json_t, str.str) + len + 1));
+    self->type = JSON_TYPE_STRING;
+    self->in_arena = arena != NULL;
+    memcpy(self->str.str, data, len);
+    self->str.str[len] = '\0';
+    self->str.refcnt = 1;
+    return self;
+error:
+    return NULL;
+}
 
-static const char* check_number(const char* str)
+///
+///@brief Create string node referencing len symbols of input buffer without copying
+/// \n Symbols should not have escapes and NUL, buffer should outlive node
+///
+static json_t* json_init_view(json_arena_t* arena, const char* data, size_t len)
 {
     log_trace_func();
-    log_debug_msg("check:'%s'", str);
-    const char* iterator = str;
-    const char* ret = NULL;
-    reader_t reader = reader_init((json_getc_t)json_get_c_str, &iterator);
-    CHECK_FUNC(parse_number(&reader));
-    iterator--;
-    if (iterator[0] != 0) {
-        log_debug_msg("extra symbols('%s') in number string:'%s'", &iterator[0], str);
-        goto error;
-    }
-    ret = str;
+    json_t* self = CHECK_FUNC(json_node_alloc(arena, offsetof(json_t, view.copy) + sizeof(self->view.copy[0])));
+    self->type = JSON_TYPE_STRING;
+    self->in_arena = arena != NULL;
+    self->is_view = 1;
+    self->view.refcnt = 1;
+    self->view.len = (unsigned)len;
+    self->view.data = data;
+    return self;
 error:
-    reader_cleanup(&reader);
-    return ret;
+    return NULL;
 }
 
-json_t* json_init_from_value(const char* type_str, const char* value_str)
+///
+///@brief Create container with given elements, elements are moved into it
+///
+static json_t* json_init_container(json_arena_t* arena, json_type_t type, json_t** nodes, size_t size)
 {
     log_trace_func();
-    ASSERT_NULL(type_str);
-    log_debug_msg("type_str:'%s'", type_str);
+    json_t* self = CHECK_FUNC(json_node_alloc(arena, sizeof(json_t) + size * sizeof(json_t*)));
+    self->type = type;
+    self->in_arena = arena != NULL;
+    self->arr.size = (unsigned)size;
+    self->arr.refcnt = 1;
+    self->capacity = (unsigned)size;
+    for (size_t i = 0; i < size; i++) {
+        self->arr.nodes[i] = json_node_stored(nodes[i]);
+        if (json_has_views(nodes[i])) {
+            self->has_views = 1;
+        }
+    }
+    if (type == JSON_TYPE_OBJECT) {
+        self->arr.index = json_index_build(self);
+    }
+    return self;
+error:
+    return NULL;
+}
+
+static const char* parse_number(reader_t* reader);
+
+static const char* check_number(const char* str)
+{
+    log_trace_func();
+    log_debug_msg("check:'%s'", str);
+    const char* ret = NULL;
+    size_t len = strlen(str);
+    json_parser_t parser;
+    memset(&parser, 0, sizeof(parser));
+    reader_t reader = reader_init_buf(&parser, str, len);
+    CHECK_FUNC(parse_number(&reader));
+    if (reader_tell(&reader) != len) {
+        log_debug_msg("extra symbols('%s') in number string:'%s'", &str[reader_tell(&reader)], str);
+        goto error;
+    }
+    ret = str;
+error:
+    json_parser_cleanup(&parser);
+    return ret;
+}
+
+static json_t* json_init_from_value_(json_arena_t* arena, const char* type_str, const char* value_str)
+{
+    log_trace_func();
+    ASSERT_NULL(type_str);
+    log_debug_msg("type_str:'%s'", type_str);
     const json_type_t* type = CHECK_FUNC(str2type(type_str));
     switch (*type) {
     case JSON_TYPE_NUMBER: {
@@ -726,11 +1927,24 @@ json_t* json_init_from_value(const char* type_str, const char* value_str)
     default:
         break;
     }
-    return CHECK_FUNC(json_init_from_value_internal(*type, value_str));
+    return CHECK_FUNC(json_init_from_value_internal(arena, *type, value_str));
 error:
     return NULL;
 }
 
+json_t* json_init_from_value(const char* type_str, const char* value_str)
+{
+    log_trace_func();
+    return json_init_from_value_(NULL, type_str, value_str);
+}
+
+json_t* json_arena_init_from_value(json_arena_t* arena, const char* type_str, const char* value_str)
+{
+    log_trace_func();
+    ASSERT_NULL(arena);
+    return json_init_from_value_(arena, type_str, value_str);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// PARSER
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -782,22 +1996,23 @@ static int json_chex2num(char c)
 static void skipspaces(reader_t* reader)
 {
     log_trace_func();
-    if (isspace(cur_c(reader))) {
-        do {
-        } while (isspace(get_c(reader)));
+    while (scan_isspace(cur_c(reader))) {
+        // kernel is called only for run of spaces, single space is common between tokens
+        if (reader->pos != reader->end && scan_isspace(*reader->pos)) {
+            reader->pos = reader->spaces(reader->pos, reader->end);
+        }
+        get_c(reader);
     }
 }
 
-static int expect_token(reader_t* reader, char c)
+///
+///@brief Skip spaces before token and remember token begin as point to restart parsing from
+///
+static void skip_to_token(reader_t* reader)
 {
     log_trace_func();
     skipspaces(reader);
-    if (cur_c(reader) != c) {
-        log_debug_msg("%s not found", symbol_str(c));
-        return 0;
-    }
-    log_debug_msg("%s found", symbol_str(c));
-    return 1;
+    reader->parser->checkpoint = reader_tell(reader);
 }
 
 #define PARSE_DIGIT_SEQ(reader)                          \
@@ -821,18 +2036,37 @@ static int expect_token(reader_t* reader, char c)
 
 #define UTF8_SEQ_VAL_BITS 6
 
-static json_t* json_parse_string(reader_t* reader)
+///
+///@brief Check opening quote of string and prepare scratch buffer for its symbols
+///
+static int json_parse_string_begin(reader_t* reader)
 {
     log_trace_func();
     log_debug_msg("parse %s", JSON_STRING);
-    if (expect_token(reader, '"') == 0) {
+    if (cur_c(reader) != '"') {
         UNEXPECTED_SYMBOL(reader);
-        return NULL;
     }
     READER_RESET_S(reader);
-    for (char symbol = get_c(reader); symbol != '"'; symbol = get_c(reader)) {
+    get_c(reader);
+    return 0;
+error:
+    return -1;
+}
+
+///
+///@brief Store symbols of string into scratch buffer till closing quote
+///@return 1 - closing quote is current symbol, 0 - input starved, -1 - error
+/// \n When input starved parser checkpoint points to the first symbol not stored yet,
+/// so parsing may be continued from it with the same scratch buffer.
+///
+static int json_parse_string_body(reader_t* reader)
+{
+    log_trace_func();
+    size_t start = 0;
+    for (char symbol = cur_c(reader); symbol != '"'; symbol = get_c(reader)) {
         switch (symbol) {
         case '\\': {
+            start = reader_tell(reader);
             switch (get_c(reader)) {
             case '"':
             case '\\':
@@ -861,7 +2095,6 @@ static json_t* json_parse_string(reader_t* reader)
                     int intermediate = json_chex2num(get_c(reader));
                     if (intermediate < 0) {
                         UNEXPECTED_SYMBOL(reader);
-                        return NULL;
                     }
                     result = result * 16 + (unsigned)intermediate;
                 }
@@ -895,20 +2128,61 @@ static json_t* json_parse_string(reader_t* reader)
             }
             default:
                 UNEXPECTED_SYMBOL(reader);
-                return NULL;
             }
             READER_PUT2S(reader, symbol);
             break;
         }
         case '\0': {
+            start = reader_tell(reader);
             UNEXPECTED_SYMBOL(reader);
-            return NULL;
         }
-        default:
-            READER_PUT2S(reader, symbol);
+        default: {
+            const char* run = reader->pos - 1;
+            reader->pos = scan_string(reader->pos, reader->end);
+            READER_PUTN2S(reader, run, (size_t)(reader->pos - run));
+        }
+        }
+    }
+    return 1;
+error:
+    if (reader->starved) {
+        log_debug_msg("input starved, continue from %zu", start);
+        reader->parser->checkpoint = start;
+        return 0;
+    }
+    return -1;
+}
+
+///
+///@brief Parse string value or key decoding it in place of input, string is NUL terminated in place of its end
+/// \n Decoded string is never longer than its source, so it always fits in place of source
+///
+static json_t* json_parse_string_insitu(reader_t* reader)
+{
+    log_trace_func();
+    json_parser_t* parser = reader->parser;
+    char* data = (char*)reader->pos;
+    const char* end = scan_string(reader->pos, reader->end);
+    size_t len = (size_t)(end - data);
+    if (end < reader->end && *end == '"') {
+        reader->pos = end;
+        get_c(reader);
+    } else {
+        if (json_parse_string_begin(reader) != 0 || json_parse_string_body(reader) != 1) {
+            goto error;
         }
+        len = parser->tmp.stored;
+        memcpy(data, reader_get_s(reader), len);
     }
-    return CHECK_FUNC(json_init_from_value_internal(JSON_TYPE_STRING, reader_get_s(reader)));
+    if (len > UINT_MAX) {
+        log_error_msg("string of %zu symbols is too long", len);
+        goto error;
+    }
+    data[len] = '\0';
+    json_t* self = CHECK_FUNC(json_init_view(parser->arena, data, len));
+    // terminated view does not need copy
+    self->view.copy[0] = data;
+    return self;
 error:
     return NULL;
 }
@@ -947,113 +2221,1136 @@ error:
     return NULL;
 }
 
-static json_t* json_parse(reader_t* reader)
+typedef enum parse_status_t {
+    PARSE_ERROR = -1,
+    PARSE_STARVED,
+    PARSE_DONE,
+} parse_status_t;
+
+#define CHECK_STARVED(reader) ({        \
+    if ((reader)->starved) {            \
+        log_debug_msg("input starved"); \
+        goto starved;                   \
+    }                                   \
+})
+
+///
+///@brief Drop references of intern table to keys
+///
+static void json_parse_keys_release(json_parser_t* parser)
 {
     log_trace_func();
-    skipspaces(reader);
-    char symbol = cur_c(reader);
-    json_t* value = NULL;
-    json_t* elem = NULL;
-    json_t* key = NULL;
-    switch (symbol) {
-    case ARRAY_BEGIN: {
-        log_debug_msg("parse %s", JSON_ARRAY);
-        get_c(reader);
-        value = CHECK_FUNC(json_init_from_value(JSON_ARRAY, NULL));
-        if (expect_token(reader, ARRAY_END)) {
-            break;
+    for (size_t id = 0; parser->keys.count > 0 && id < parser->keys.size; id++) {
+        if (parser->keys.nodes[id] != NULL) {
+            json_release(parser->keys.nodes[id]);
+            parser->keys.nodes[id] = NULL;
+            parser->keys.count--;
         }
-        do {
-            elem = CHECK_FUNC(json_parse(reader));
-            if (elem->type != JSON_TYPE_NUMBER) {
-                get_c(reader);
-            }
-            CHECK_FUNC(json_set_by_id_(&value, &elem, value->arr.size, 0));
-        } while (expect_token(reader, COMMA) && (get_c(reader) || 1));
-        if (expect_token(reader, ARRAY_END) == 0) {
-            UNEXPECTED_SYMBOL(reader);
-            return NULL;
+    }
+}
+
+static json_t** json_parse_keys_slot(json_parser_t* parser, const char* key, size_t hash)
+{
+    size_t mask = parser->keys.size - 1;
+    for (size_t id = hash & mask;; id = (id + 1) & mask) {
+        json_t** slot = &parser->keys.nodes[id];
+        if (*slot == NULL || strcmp((*slot)->str.str, key) == 0) {
+            return slot;
         }
+    }
+}
+
+///
+///@brief Grow intern table, keys are kept in table of previous size on failure
+///
+static json_t** json_parse_keys_grow(json_parser_t* parser)
+{
+    log_trace_func();
+    size_t size = parser->keys.size ? parser->keys.size * 2 : PARSER_KEYS_MIN_SIZE;
+    json_t** old = parser->keys.nodes;
+    size_t old_size = parser->keys.size;
+    json_t** nodes = CALLOC(size, sizeof(json_t*));
+    parser->keys.nodes = nodes;
+    parser->keys.size = size;
+    for (size_t id = 0; id < old_size; id++) {
+        if (old[id] != NULL) {
+            size_t len;
+            *json_parse_keys_slot(parser, old[id]->str.str, json_key_hash(old[id]->str.str, &len)) = old[id];
+        }
+    }
+    FREE(old);
+    return nodes;
+error:
+    return NULL;
+}
+
+///
+///@brief Create key node from scratch buffer, repeated keys share one node
+///
+static json_t* json_parse_key(json_parser_t* parser)
+{
+    log_trace_func();
+    const char* key = parser->tmp.data;
+    size_t len;
+    size_t hash = json_key_hash(key, &len);
+    if (len != parser->tmp.stored) {
+        log_debug_msg("key with NUL is not interned");
+        return json_init_from_value_internal(parser->arena, JSON_TYPE_STRING, key);
+    }
+    if (parser->keys.count < PARSER_KEYS_MAX_COUNT && (parser->keys.count + 1) * 2 > parser->keys.size) {
+        CHECK_FUNC(json_parse_keys_grow(parser));
+    }
+    if (parser->keys.count * 2 >= parser->keys.size) {
+        log_debug_msg("intern table is full");
+        return json_init_from_value_internal(parser->arena, JSON_TYPE_STRING, key);
+    }
+    json_t** slot = json_parse_keys_slot(parser, key, hash);
+    if (*slot != NULL) {
+        REFCNT_INC((*slot)->str.refcnt);
+        return *slot;
+    }
+    json_t* self = CHECK_FUNC(json_init_from_value_internal(parser->arena, JSON_TYPE_STRING, key));
+    REFCNT_INC(self->str.refcnt);
+    *slot = self;
+    parser->keys.count++;
+    return self;
+error:
+    return NULL;
+}
+
+///
+///@brief Release value parsed partially and reset parser state
+///
+static void json_parse_reset(json_parser_t* parser)
+{
+    log_trace_func();
+    if (!parser->keys.keep || parser->arena != NULL) {
+        json_parse_keys_release(parser);
+    }
+    for (json_t** value; (value = STACK_TOP(&parser->values, json_t*)) != NULL;) {
+        json_deinit(value);
+        STACK_POP(&parser->values, json_t*);
+    }
+    parser->stack.size = 0;
+    parser->state = PARSE_VALUE;
+}
+
+///
+///@brief Nodes marking type of values parsed by sax handlers, tree is not built
+///
+static json_t sax_nodes[] = {
+    [JSON_TYPE_NUMBER] = { JSON_TYPE_NUMBER, 0, 0, 0, 0, 0, 0, { { 0 } } },
+    [JSON_TYPE_STRING] = { JSON_TYPE_STRING, 0, 0, 0, 0, 0, 0, { { 0 } } },
+    [JSON_TYPE_ARRAY] = { JSON_TYPE_ARRAY, 0, 0, 0, 0, 0, 0, { { 0 } } },
+    [JSON_TYPE_OBJECT] = { JSON_TYPE_OBJECT, 0, 0, 0, 0, 0, 0, { { 0 } } },
+};
+
+#define SAX_EVENT(parser, event, ...) ({                                                                                 \
+    if ((parser)->sax->event != NULL && (parser)->sax->event((parser)->sax_data __VA_OPT__(, ) __VA_ARGS__) != 0) { \
+        log_debug_msg("parsing stopped by " #event);                                                                   \
+        goto error;                                                                                                     \
+    }                                                                                                                   \
+})
+
+///
+///@brief Pass finished value to sax handlers
+/// \n Symbols of string or number are still stored in scratch buffer
+///
+static int json_sax_value(json_parser_t* parser, const json_t* value)
+{
+    log_trace_func();
+    switch (value->type) {
+    case JSON_TYPE_NULL:
+        SAX_EVENT(parser, on_null);
+        break;
+    case JSON_TYPE_FALSE:
+    case JSON_TYPE_TRUE:
+        SAX_EVENT(parser, on_bool, value->type == JSON_TYPE_TRUE);
+        break;
+    case JSON_TYPE_NUMBER:
+        SAX_EVENT(parser, on_number, parser->tmp.data, parser->tmp.stored);
+        break;
+    case JSON_TYPE_STRING:
+        SAX_EVENT(parser, on_string, parser->tmp.data, parser->tmp.stored);
+        break;
+    case JSON_TYPE_ARRAY:
+        SAX_EVENT(parser, on_end_array);
+        break;
+    case JSON_TYPE_OBJECT:
+        SAX_EVENT(parser, on_end_object);
+        break;
+    default:
         break;
     }
-    case OBJECT_BEGIN: {
-        log_debug_msg("parse %s", JSON_OBJECT);
-        get_c(reader);
-        value = CHECK_FUNC(json_init_from_value_internal(JSON_TYPE_OBJECT, NULL));
-        log_debug_msg(JSON_FORMAT(&value));
-        if (expect_token(reader, OBJECT_END)) {
+    return 0;
+error:
+    return -1;
+}
+
+///
+///@brief Container not finished yet, its elements are on parser values stack starting from base
+///
+typedef struct parse_frame_t {
+    json_type_t type;
+    size_t base;
+} parse_frame_t;
+
+static char json_container_end(const parse_frame_t* frame)
+{
+    return frame->type == JSON_TYPE_ARRAY ? ARRAY_END : OBJECT_END;
+}
+
+///
+///@brief Create container of finished frame at once, elements are moved from values stack
+///
+static json_t* json_parse_close(json_parser_t* parser, const parse_frame_t* frame)
+{
+    log_trace_func();
+    if (parser->sax != NULL) {
+        return &sax_nodes[frame->type];
+    }
+    size_t size = STACK_SIZE(&parser->values, json_t*) - frame->base;
+    json_t** nodes = (json_t**)(void*)parser->values.data + frame->base;
+    log_debug_msg("close %s of %zu elements", type2str(frame->type), size);
+    json_t* self = CHECK_FUNC(json_init_container(parser->arena, frame->type, nodes, size));
+    parser->values.size -= size * sizeof(json_t*);
+    return self;
+error:
+    return NULL;
+}
+
+///
+///@brief Parse value without recursion
+/// \n Containers opened but not finished are stored on parser stack,
+/// so parsing may be stopped when input starved and continued with next input
+/// from parser checkpoint.
+///@return PARSE_DONE - result stored, PARSE_STARVED - more input required, PARSE_ERROR - parsing error
+///
+static parse_status_t json_parse_run(reader_t* reader, json_t** result)
+{
+    log_trace_func();
+    json_parser_t* parser = reader->parser;
+    json_stack_t* stack = &parser->stack;
+    json_t* value = NULL;
+    for (;;) {
+        parser->checkpoint = reader_tell(reader);
+        parse_frame_t* frame = STACK_TOP(stack, parse_frame_t);
+        switch (parser->state) {
+        case PARSE_VALUE: {
+            skip_to_token(reader);
+            CHECK_STARVED(reader);
+            char symbol = cur_c(reader);
+            switch (symbol) {
+            case ARRAY_BEGIN:
+            case OBJECT_BEGIN: {
+                json_type_t type = symbol == ARRAY_BEGIN ? JSON_TYPE_ARRAY : JSON_TYPE_OBJECT;
+                log_debug_msg("parse %s", type2str(type));
+                if (parser->max_depth != 0 && STACK_SIZE(stack, parse_frame_t) == parser->max_depth) {
+                    log_error_msg("max depth %zu reached", parser->max_depth);
+                    goto error;
+                }
+                frame = CHECK_FUNC(STACK_PUSH(stack, parse_frame_t));
+                frame->type = type;
+                frame->base = STACK_SIZE(&parser->values, json_t*);
+                if (parser->sax != NULL && type == JSON_TYPE_ARRAY) {
+                    SAX_EVENT(parser, on_start_array);
+                } else if (parser->sax != NULL) {
+                    SAX_EVENT(parser, on_start_object);
+                }
+                get_c(reader);
+                parser->state = PARSE_FIRST;
+                continue;
+            }
+            case '"': {
+                if (reader->insitu) {
+                    value = CHECK_FUNC(json_parse_string_insitu(reader));
+                    break;
+                }
+                if (parser->views && reader->stable && parser->sax == NULL) {
+                    // string without escapes is referenced where it is
+                    const char* end = scan_string(reader->pos, reader->end);
+                    if (end < reader->end && *end == '"' && (size_t)(end - reader->pos) <= UINT_MAX) {
+                        value = CHECK_FUNC(json_init_view(parser->arena, reader->pos, (size_t)(end - reader->pos)));
+                        reader->pos = end;
+                        get_c(reader);
+                        break;
+                    }
+                }
+                if (json_parse_string_begin(reader) != 0) {
+                    goto error;
+                }
+                parser->state = PARSE_STRING;
+                continue;
+            }
+            case 't':
+            case 'f':
+            case 'n': {
+                const char* types[] = {
+                    ['t'] = JSON_TRUE,
+                    ['f'] = JSON_FALSE,
+                    ['n'] = JSON_NULL,
+                };
+                const char* type = types[(unsigned)symbol];
+                log_debug_msg("parse %s", type);
+                for (size_t idx = 1; type[idx] != '\0'; idx++) {
+                    get_c(reader);
+                    if (type[idx] != cur_c(reader)) {
+                        UNEXPECTED_SYMBOL(reader);
+                    }
+                }
+                value = json_init_from_value(type, NULL);
+                break;
+            }
+            default: {
+                log_debug_msg("parse %s", JSON_NUMBER);
+                const char* number = CHECK_FUNC(parse_number(reader));
+                // number may continue in next input
+                CHECK_STARVED(reader);
+                if (parser->sax != NULL) {
+                    value = &sax_nodes[JSON_TYPE_NUMBER];
+                    break;
+                }
+                value = CHECK_FUNC(json_init_from_value_internal(parser->arena, JSON_TYPE_NUMBER, number));
+                break;
+            }
+            }
             break;
         }
-        do {
-            key = CHECK_FUNC(json_parse_string(reader));
-            CHECK_FUNC(json_set_by_id_(&value, &key, value->arr.size, 0));
+        case PARSE_STRING:
+        case PARSE_KEY_STRING: {
+            switch (json_parse_string_body(reader)) {
+            case 1:
+                break;
+            case 0:
+                goto starved;
+            default:
+                goto error;
+            }
+            if (parser->state == PARSE_STRING && parser->sax != NULL) {
+                value = &sax_nodes[JSON_TYPE_STRING];
+                break;
+            }
+            if (parser->state == PARSE_STRING) {
+                value = CHECK_FUNC(json_init_from_value_internal(parser->arena, JSON_TYPE_STRING, reader_get_s(reader)));
+                break;
+            }
+            if (parser->sax != NULL) {
+                SAX_EVENT(parser, on_key, parser->tmp.data, parser->tmp.stored);
+            } else {
+                json_t** key = CHECK_FUNC(STACK_PUSH(&parser->values, json_t*));
+                *key = &node_null;
+                *key = CHECK_FUNC(json_parse_key(parser));
+            }
             get_c(reader);
-            if (expect_token(reader, OBJECT_DIV) == 0) {
+            parser->state = PARSE_OBJECT_DIV;
+            continue;
+        }
+        case PARSE_FIRST: {
+            skip_to_token(reader);
+            CHECK_STARVED(reader);
+            if (cur_c(reader) == json_container_end(frame)) {
+                value = CHECK_FUNC(json_parse_close(parser, frame));
+                STACK_POP(stack, parse_frame_t);
+                break;
+            }
+            parser->state = frame->type == JSON_TYPE_OBJECT ? PARSE_KEY : PARSE_VALUE;
+            continue;
+        }
+        case PARSE_KEY: {
+            skip_to_token(reader);
+            CHECK_STARVED(reader);
+            if (reader->insitu && cur_c(reader) == '"') {
+                // keys are not interned: intern table may outlive input buffer
+                json_t** key = CHECK_FUNC(STACK_PUSH(&parser->values, json_t*));
+                *key = &node_null;
+                *key = CHECK_FUNC(json_parse_string_insitu(reader));
+                get_c(reader);
+                parser->state = PARSE_OBJECT_DIV;
+                continue;
+            }
+            if (json_parse_string_begin(reader) != 0) {
+                goto error;
+            }
+            parser->state = PARSE_KEY_STRING;
+            continue;
+        }
+        case PARSE_OBJECT_DIV: {
+            skip_to_token(reader);
+            CHECK_STARVED(reader);
+            if (cur_c(reader) != OBJECT_DIV) {
                 UNEXPECTED_SYMBOL(reader);
-                return NULL;
             }
             get_c(reader);
-            elem = CHECK_FUNC(json_parse(reader));
-            if (elem->type != JSON_TYPE_NUMBER) {
+            parser->state = PARSE_VALUE;
+            continue;
+        }
+        case PARSE_NEXT: {
+            skip_to_token(reader);
+            CHECK_STARVED(reader);
+            if (cur_c(reader) == COMMA) {
                 get_c(reader);
+                parser->state = frame->type == JSON_TYPE_OBJECT ? PARSE_KEY : PARSE_VALUE;
+                continue;
+            }
+            if (cur_c(reader) != json_container_end(frame)) {
+                UNEXPECTED_SYMBOL(reader);
+            }
+            value = CHECK_FUNC(json_parse_close(parser, frame));
+            STACK_POP(stack, parse_frame_t);
+            break;
+        }
+        default:
+            log_error_msg("wrong parser state %i", parser->state);
+            goto error;
+        }
+        log_debug_msg("parsed:" JSON_FORMAT(&value));
+        if (parser->sax != NULL && json_sax_value(parser, value) != 0) {
+            goto error;
+        }
+        if (STACK_TOP(stack, parse_frame_t) == NULL) {
+            log_debug_msg("parsing success:" JSON_FORMAT(&value));
+            parser->state = PARSE_VALUE;
+            if (!parser->keys.keep || parser->arena != NULL) {
+                json_parse_keys_release(parser);
             }
-            CHECK_FUNC(json_set_by_id_(&value, &elem, value->arr.size, 0));
-        } while (expect_token(reader, COMMA) && (get_c(reader) || 1));
+            *result = value;
+            return PARSE_DONE;
+        }
+        int is_number = value->type == JSON_TYPE_NUMBER;
+        if (parser->sax == NULL) {
+            *CHECK_FUNC(STACK_PUSH(&parser->values, json_t*)) = value;
+        }
+        value = NULL;
+        if (!is_number) {
+            get_c(reader);
+        }
+        parser->state = PARSE_NEXT;
+    }
+error:
+    if (!reader->starved) {
+        if (parser->sax == NULL) {
+            json_deinit(&value);
+        }
+        json_parse_reset(parser);
+        return PARSE_ERROR;
+    }
+starved:
+    // checkpoint is at begin of unfinished token, it will be parsed again
+    if (value != NULL && parser->sax == NULL) {
+        json_deinit(&value);
+    }
+    return PARSE_STARVED;
+}
 
-        if (expect_token(reader, OBJECT_END) == 0) {
-            UNEXPECTED_SYMBOL(reader);
-            return NULL;
+static json_t* json_parse(reader_t* reader)
+{
+    log_trace_func();
+    json_t* value = NULL;
+    json_parse_reset(reader->parser);
+    if (json_parse_run(reader, &value) != PARSE_DONE) {
+        return NULL;
+    }
+    return value;
+}
+
+///
+///@brief Parse value calling sax handlers instead of building tree
+///
+static int json_parse_sax(reader_t* reader, const json_sax_t* sax, void* user_data, size_t* consumed)
+{
+    log_trace_func();
+    json_parser_t* parser = reader->parser;
+    json_t* value = NULL;
+    json_parse_reset(parser);
+    parser->sax = sax;
+    parser->sax_data = user_data;
+    int ret = json_parse_run(reader, &value) == PARSE_DONE ? 0 : -1;
+    parser->sax = NULL;
+    parser->sax_data = NULL;
+    *consumed = reader_tell(reader);
+    if (value != NULL && value->type != JSON_TYPE_NUMBER) {
+        (*consumed)++;
+    }
+    log_debug_msg("ret:%i consumed:%zu", ret, *consumed);
+    return ret;
+}
+
+json_t* json_init_from(json_getc_t getc, void* data)
+{
+    log_trace_func();
+    ASSERT_NULL(getc);
+    json_t* self = NULL;
+    json_parser_t parser;
+    memset(&parser, 0, sizeof(parser));
+    reader_t reader = reader_init(&parser, getc, data);
+    self = CHECK_FUNC(json_parse(&reader));
+error:
+    json_parser_cleanup(&parser);
+    return self;
+}
+
+///
+///@brief Parse value and calculate count of input symbols used by it.
+///
+static json_t* json_parse_counted(reader_t* reader, size_t* consumed)
+{
+    log_trace_func();
+    json_t* self = json_parse(reader);
+    *consumed = reader_tell(reader);
+    if (self != NULL && json_get_type(&self) != JSON_NUMBER) {
+        (*consumed)++;
+    }
+    log_debug_msg("consumed:%zu", *consumed);
+    if (self == NULL) {
+        log_error_msg("parsing error!");
+    }
+    return self;
+}
+
+json_parser_t* json_parser_init(void)
+{
+    log_trace_func();
+    return CALLOC(1, sizeof(json_parser_t));
+error:
+    return NULL;
+}
+
+void json_parser_deinit(json_parser_t** self)
+{
+    log_trace_func();
+    ASSERT_PPTR(self, ;);
+    json_parser_cleanup(*self);
+    FREE_PTR(self);
+}
+
+void json_parser_set_max_depth(json_parser_t* self, size_t max_depth)
+{
+    log_trace_func();
+    ASSERT_NULL(self, ;);
+    log_debug_msg("max_depth:%zu", max_depth);
+    self->max_depth = max_depth;
+}
+
+void json_parser_set_views(json_parser_t* self, int views)
+{
+    log_trace_func();
+    ASSERT_NULL(self, ;);
+    log_debug_msg("views:%i", views);
+    self->views = views;
+}
+
+void json_parser_set_arena(json_parser_t* self, json_arena_t* arena)
+{
+    log_trace_func();
+    ASSERT_NULL(self, ;);
+    log_debug_msg("arena:%p", arena);
+    // kept keys are not shared between arenas and heap
+    json_parse_keys_release(self);
+    self->arena = arena;
+}
+
+void json_parser_set_keep_keys(json_parser_t* self, int keep)
+{
+    log_trace_func();
+    ASSERT_NULL(self, ;);
+    log_debug_msg("keep:%i", keep);
+    self->keys.keep = keep ? 1 : 0;
+    if (!self->keys.keep) {
+        json_parse_keys_release(self);
+    }
+}
+
+json_t* json_parser_parse_buf(json_parser_t* self, const char* data, size_t len, size_t* consumed)
+{
+    log_trace_func();
+    if (consumed != NULL) {
+        *consumed = 0;
+    }
+    ASSERT_NULL(self);
+    ASSERT_NULL(data);
+    size_t used = 0;
+    reader_t reader = reader_init_buf(self, data, len);
+    json_t* value = json_parse_counted(&reader, &used);
+    if (consumed != NULL) {
+        *consumed = used;
+    }
+    return value;
+}
+
+json_t* json_parser_parse_insitu(json_parser_t* self, char* data, size_t len, size_t* consumed)
+{
+    log_trace_func();
+    if (consumed != NULL) {
+        *consumed = 0;
+    }
+    ASSERT_NULL(self);
+    ASSERT_NULL(data);
+    size_t used = 0;
+    reader_t reader = reader_init_buf(self, data, len);
+    reader.insitu = 1;
+    json_t* value = json_parse_counted(&reader, &used);
+    if (consumed != NULL) {
+        *consumed = used;
+    }
+    return value;
+}
+
+json_t* json_parser_parse_reader(json_parser_t* self, json_read_t read, void* data)
+{
+    log_trace_func();
+    ASSERT_NULL(self);
+    ASSERT_NULL(read);
+    reader_t reader = reader_init_read(self, read, data);
+    return CHECK_FUNC(json_parse(&reader));
+error:
+    return NULL;
+}
+
+int json_parser_sax_buf(json_parser_t* self, const json_sax_t* sax, void* user_data, const char* data, size_t len, size_t* consumed)
+{
+    log_trace_func();
+    if (consumed != NULL) {
+        *consumed = 0;
+    }
+    ASSERT_NULL(self, -1);
+    ASSERT_NULL(sax, -1);
+    ASSERT_NULL(data, -1);
+    size_t used = 0;
+    reader_t reader = reader_init_buf(self, data, len);
+    int ret = json_parse_sax(&reader, sax, user_data, &used);
+    if (consumed != NULL) {
+        *consumed = used;
+    }
+    return ret;
+}
+
+int json_parser_sax_reader(json_parser_t* self, const json_sax_t* sax, void* user_data, json_read_t read, void* data)
+{
+    log_trace_func();
+    ASSERT_NULL(self, -1);
+    ASSERT_NULL(sax, -1);
+    ASSERT_NULL(read, -1);
+    size_t used = 0;
+    reader_t reader = reader_init_read(self, read, data);
+    return json_parse_sax(&reader, sax, user_data, &used);
+}
+
+json_push_parser_t* json_push_init(void)
+{
+    log_trace_func();
+    return CALLOC(1, sizeof(json_push_parser_t));
+error:
+    return NULL;
+}
+
+void json_push_deinit(json_push_parser_t** self)
+{
+    log_trace_func();
+    ASSERT_PPTR(self, ;);
+    json_parse_reset(&(*self)->parser);
+    json_parser_cleanup(&(*self)->parser);
+    if ((*self)->result != NULL) {
+        json_deinit(&(*self)->result);
+    }
+    FREE((*self)->carry.data);
+    FREE_PTR(self);
+}
+
+void json_push_set_max_depth(json_push_parser_t* self, size_t max_depth)
+{
+    log_trace_func();
+    ASSERT_NULL(self, ;);
+    json_parser_set_max_depth(&self->parser, max_depth);
+}
+
+///
+///@brief Keep input symbols starting from parser checkpoint till next feeding
+/// \n Input consists of symbols kept before and new data
+///
+static int json_push_keep(json_push_parser_t* self, const char* data, size_t len)
+{
+    log_trace_func();
+    size_t from = self->parser.checkpoint;
+    if (from < self->carry.size) {
+        memmove(self->carry.data, &self->carry.data[from], self->carry.size - from);
+        self->carry.size -= from;
+        from = 0;
+    } else {
+        from -= self->carry.size;
+        self->carry.size = 0;
+    }
+    if (from == len) {
+        // nothing of chunk is kept, carry may be not allocated yet
+        return 0;
+    }
+    size_t size = self->carry.size + len - from;
+    if (size > self->carry.capacity) {
+        size_t capacity = self->carry.capacity ? self->carry.capacity * 2 : PARSER_TMP_MIN_SIZE;
+        while (capacity < size) {
+            capacity *= 2;
         }
-        break;
+        self->carry.data = REALLOC(self->carry.data, capacity);
+        self->carry.capacity = capacity;
     }
-    case '"': {
-        value = CHECK_FUNC(json_parse_string(reader));
+    memcpy(&self->carry.data[self->carry.size], &data[from], len - from);
+    self->carry.size = size;
+    log_debug_msg("kept %zu symbols", size);
+    return 0;
+error:
+    return -1;
+}
+
+json_push_status_t json_push_feed(json_push_parser_t* self, const char* data, size_t len, size_t* consumed)
+{
+    log_trace_func();
+    if (consumed != NULL) {
+        *consumed = 0;
+    }
+    ASSERT_NULL(self, JSON_PUSH_ERROR);
+    ASSERT_NULL(data, JSON_PUSH_ERROR);
+    if (self->result != NULL) {
+        log_error_msg("parsed value is not taken");
+        return JSON_PUSH_ERROR;
+    }
+    json_t* value = NULL;
+    size_t used = 0;
+    json_push_status_t status = JSON_PUSH_ERROR;
+    reader_t reader = reader_init_push(&self->parser, self->carry.data, self->carry.size, data, len);
+    switch (json_parse_run(&reader, &value)) {
+    case PARSE_DONE:
+        // value can't end inside kept symbols, they are part of token not finished before
+        used = reader_tell(&reader) - self->carry.size;
+        if (value->type != JSON_TYPE_NUMBER) {
+            used++;
+        }
+        self->carry.size = 0;
+        self->result = value;
+        status = JSON_PUSH_DONE;
+        break;
+    case PARSE_STARVED:
+        if (json_push_keep(self, data, len) != 0) {
+            json_parse_reset(&self->parser);
+            self->carry.size = 0;
+            break;
+        }
+        used = len;
+        status = JSON_PUSH_NEED_MORE;
+        break;
+    default:
+        log_error_msg("parsing error!");
+        self->carry.size = 0;
         break;
     }
-    case 't':
-    case 'f':
-    case 'n': {
-        const char* types[] = {
-            ['t'] = JSON_TRUE,
-            ['f'] = JSON_FALSE,
-            ['n'] = JSON_NULL,
-        };
-        const char* type = types[(unsigned)symbol];
-        log_debug_msg("parse %s", type);
-        for (size_t idx = 1; type[idx] != '\0'; idx++) {
-            get_c(reader);
-            if (type[idx] != cur_c(reader)) {
+    log_debug_msg("status:%i consumed:%zu", status, used);
+    if (consumed != NULL) {
+        *consumed = used;
+    }
+    return status;
+}
+
+json_push_status_t json_push_finish(json_push_parser_t* self)
+{
+    log_trace_func();
+    ASSERT_NULL(self, JSON_PUSH_ERROR);
+    if (self->result != NULL) {
+        return JSON_PUSH_DONE;
+    }
+    json_t* value = NULL;
+    reader_t reader = reader_init_buf(&self->parser, self->carry.size ? self->carry.data : "", self->carry.size);
+    parse_status_t status = json_parse_run(&reader, &value);
+    self->carry.size = 0;
+    if (status != PARSE_DONE) {
+        log_error_msg("input finished inside value");
+        json_parse_reset(&self->parser);
+        return JSON_PUSH_ERROR;
+    }
+    self->result = value;
+    return JSON_PUSH_DONE;
+}
+
+json_t* json_push_take(json_push_parser_t* self)
+{
+    log_trace_func();
+    ASSERT_NULL(self);
+    json_t* value = self->result;
+    self->result = NULL;
+    return value;
+}
+
+json_t* json_init_from_buf(const char* data, size_t len, size_t* consumed)
+{
+    log_trace_func();
+    json_parser_t parser;
+    memset(&parser, 0, sizeof(parser));
+    json_t* self = json_parser_parse_buf(&parser, data, len, consumed);
+    json_parser_cleanup(&parser);
+    return self;
+}
+
+///
+///@brief Node of tree of JSON Pointer paths selected by projection
+///
+typedef struct json_path_node_t {
+    const char* token; ///< decoded reference token
+    size_t index; ///< token as array index, SIZE_MAX if token is not index
+    size_t child; ///< first child, 0 - no children
+    size_t sibling; ///< next child of parent, 0 - last child
+    unsigned whole : 1; ///< value selected with all its content
+} json_path_node_t;
+
+typedef struct json_path_tree_t {
+    json_path_node_t* nodes; ///< root is first node
+    size_t count;
+    char* tokens;
+} json_path_tree_t;
+
+static void json_path_tree_cleanup(json_path_tree_t* tree)
+{
+    FREE(tree->nodes);
+    FREE(tree->tokens);
+    tree->count = 0;
+}
+
+///
+///@brief Array index of token, leading zeros not allowed by RFC 6901
+///
+static size_t json_path_index(const char* token)
+{
+    size_t len = strlen(token);
+    if (len == 0 || len > 18 || (len > 1 && token[0] == '0')) {
+        return SIZE_MAX;
+    }
+    size_t index = 0;
+    for (size_t i = 0; i < len; i++) {
+        int digit = json_cdec2num(token[i]);
+        if (digit < 0) {
+            return SIZE_MAX;
+        }
+        index = index * 10 + (size_t)digit;
+    }
+    return index;
+}
+
+///
+///@brief Find child of node with given token or add new one
+///
+static size_t json_path_child(json_path_tree_t* tree, size_t parent, const char* token)
+{
+    size_t child = tree->nodes[parent].child;
+    for (; child != 0; child = tree->nodes[child].sibling) {
+        if (strcmp(tree->nodes[child].token, token) == 0) {
+            return child;
+        }
+    }
+    child = tree->count++;
+    tree->nodes[child].token = token;
+    tree->nodes[child].index = json_path_index(token);
+    tree->nodes[child].sibling = tree->nodes[parent].child;
+    tree->nodes[parent].child = child;
+    return child;
+}
+
+///
+///@brief Build tree of JSON Pointer (RFC 6901) paths, tokens are decoded into one buffer
+///@return 0 - success, -1 - wrong path or allocation error
+///
+static int json_path_tree_init(json_path_tree_t* tree, const char* const* paths, size_t count)
+{
+    log_trace_func();
+    size_t len = 1;
+    size_t nodes = 1;
+    for (size_t i = 0; i < count; i++) {
+        ASSERT_NULL(paths[i], -1);
+        for (const char* symbol = paths[i]; *symbol != '\0'; symbol++) {
+            nodes += *symbol == '/';
+            len++;
+        }
+        len++;
+    }
+    tree->nodes = CALLOC(nodes, sizeof(json_path_node_t));
+    tree->tokens = CALLOC(len, sizeof(char));
+    tree->nodes[0].index = SIZE_MAX;
+    tree->count = 1;
+    char* out = tree->tokens;
+    for (size_t i = 0; i < count; i++) {
+        const char* symbol = paths[i];
+        log_debug_msg("path:'%s'", symbol);
+        if (*symbol != '\0' && *symbol != '/') {
+            log_error_msg("path '%s' should start with '/'", paths[i]);
+            goto error;
+        }
+        size_t node = 0;
+        while (*symbol == '/') {
+            const char* token = out;
+            for (symbol++; *symbol != '\0' && *symbol != '/'; symbol++) {
+                if (*symbol != '~') {
+                    *out++ = *symbol;
+                } else if (symbol[1] == '0' || symbol[1] == '1') {
+                    *out++ = *++symbol == '0' ? '~' : '/';
+                } else {
+                    log_error_msg("wrong escape in path '%s'", paths[i]);
+                    goto error;
+                }
+            }
+            *out++ = '\0';
+            node = json_path_child(tree, node, token);
+        }
+        tree->nodes[node].whole = 1;
+    }
+    return 0;
+error:
+    json_path_tree_cleanup(tree);
+    return -1;
+}
+
+///
+///@brief Skip value without building it. Only strings and brackets are tracked,
+/// so skipped value is not validated and skipping does not allocate memory.
+/// \n Symbol after value becomes current.
+///@return 0 - success, -1 - value is not finished or missed
+///
+static int json_skip_value(reader_t* reader)
+{
+    log_trace_func();
+    size_t depth = 0;
+    for (char symbol = cur_c(reader);; symbol = get_c(reader)) {
+        if (reader->eof) {
+            log_error_msg("unexpected end of input");
+            return -1;
+        }
+        switch (symbol) {
+        case '"':
+            do {
+                reader->pos = scan_string(reader->pos, reader->end);
+                symbol = get_c(reader);
+                if (symbol == '\\') {
+                    get_c(reader);
+                }
+                if (reader->eof) {
+                    log_error_msg("unexpected end of input in string");
+                    return -1;
+                }
+            } while (symbol != '"');
+            break;
+        case ARRAY_BEGIN:
+        case OBJECT_BEGIN:
+            depth++;
+            continue;
+        case ARRAY_END:
+        case OBJECT_END:
+            if (depth == 0) {
+                UNEXPECTED_SYMBOL(reader);
+            }
+            depth--;
+            break;
+        case COMMA:
+        case OBJECT_DIV:
+            if (depth == 0) {
                 UNEXPECTED_SYMBOL(reader);
-                return NULL;
             }
+            continue;
+        default:
+            if (depth != 0 || scan_isspace(symbol)) {
+                continue;
+            }
+            // number or literal ends at delimiter
+            do {
+                symbol = get_c(reader);
+            } while (!reader->eof && !scan_isspace(symbol) && symbol != COMMA && symbol != ARRAY_END && symbol != OBJECT_END);
+            return 0;
+        }
+        if (depth == 0) {
+            get_c(reader);
+            return 0;
         }
-        value = json_init_from_value(type, NULL);
-        break;
     }
-    default: {
-        log_debug_msg("parse %s", JSON_NUMBER);
-        value = CHECK_FUNC(json_init_from_value_internal(JSON_TYPE_NUMBER, CHECK_FUNC(parse_number(reader))));
-        break;
+error:
+    return -1;
+}
+
+typedef struct json_projection_frame_t {
+    parse_frame_t container;
+    size_t path; ///< node of path tree for container
+    size_t index; ///< index of next array element
+} json_projection_frame_t;
+
+///
+///@brief Parse value building only subtrees selected by path tree
+/// \n Selected subtrees are parsed by regular parser, everything else skipped.
+/// Object members not on paths are dropped, array elements not on paths replaced by null.
+///
+static json_t* json_parse_projected(reader_t* reader, const json_path_tree_t* tree)
+{
+    log_trace_func();
+    const json_path_node_t* nodes = tree->nodes;
+    json_stack_t frames;
+    json_stack_t values;
+    memset(&frames, 0, sizeof(frames));
+    memset(&values, 0, sizeof(values));
+    json_projection_frame_t* frame = NULL;
+    json_t* value = NULL;
+    size_t path = 0;
+    for (;;) {
+        skipspaces(reader);
+        char symbol = cur_c(reader);
+        if (nodes[path].whole) {
+            value = CHECK_FUNC(json_parse(reader));
+            if (value->type != JSON_TYPE_NUMBER) {
+                get_c(reader);
+            }
+        } else if (symbol == ARRAY_BEGIN || symbol == OBJECT_BEGIN) {
+            frame = CHECK_FUNC(STACK_PUSH(&frames, json_projection_frame_t));
+            frame->container.type = symbol == ARRAY_BEGIN ? JSON_TYPE_ARRAY : JSON_TYPE_OBJECT;
+            frame->container.base = STACK_SIZE(&values, json_t*);
+            frame->path = path;
+            frame->index = 0;
+            get_c(reader);
+            skipspaces(reader);
+            if (cur_c(reader) != json_container_end(&frame->container)) {
+                goto member;
+            }
+            goto close;
+        } else {
+            if (json_skip_value(reader) != 0) {
+                goto error;
+            }
+        }
+    next:
+        frame = STACK_TOP(&frames, json_projection_frame_t);
+        if (frame == NULL) {
+            json_stack_cleanup(&frames);
+            json_stack_cleanup(&values);
+            return value != NULL ? value : (json_t*)&node_null;
+        }
+        if (value != NULL || frame->container.type == JSON_TYPE_ARRAY) {
+            *CHECK_FUNC(STACK_PUSH(&values, json_t*)) = value != NULL ? value : (json_t*)&node_null;
+        } else {
+            // member not selected, drop its key
+            json_deinit(STACK_TOP(&values, json_t*));
+            STACK_POP(&values, json_t*);
+        }
+        value = NULL;
+        skipspaces(reader);
+        if (cur_c(reader) == json_container_end(&frame->container)) {
+            goto close;
+        }
+        if (cur_c(reader) != COMMA) {
+            UNEXPECTED_SYMBOL(reader);
+        }
+        get_c(reader);
+        skipspaces(reader);
+    member:
+        path = nodes[frame->path].child;
+        if (frame->container.type == JSON_TYPE_ARRAY) {
+            for (; path != 0 && nodes[path].index != frame->index; path = nodes[path].sibling) { }
+            frame->index++;
+        } else {
+            if (json_parse_string_begin(reader) != 0 || json_parse_string_body(reader) != 1) {
+                goto error;
+            }
+            const char* key = reader_get_s(reader);
+            for (; path != 0 && strcmp(nodes[path].token, key) != 0; path = nodes[path].sibling) { }
+            *CHECK_FUNC(STACK_PUSH(&values, json_t*)) = &node_null;
+            if (path != 0) {
+                *STACK_TOP(&values, json_t*) = CHECK_FUNC(json_init_from_value_internal(reader->parser->arena, JSON_TYPE_STRING, key));
+            }
+            get_c(reader);
+            skipspaces(reader);
+            if (cur_c(reader) != OBJECT_DIV) {
+                UNEXPECTED_SYMBOL(reader);
+            }
+            get_c(reader);
+            skipspaces(reader);
+        }
+        if (path != 0) {
+            continue;
+        }
+        if (json_skip_value(reader) != 0) {
+            goto error;
+        }
+        goto next;
+    close: {
+        size_t size = STACK_SIZE(&values, json_t*) - frame->container.base;
+        json_t** elements = (json_t**)(void*)values.data + frame->container.base;
+        value = CHECK_FUNC(json_init_container(reader->parser->arena, frame->container.type, elements, size));
+        values.size -= size * sizeof(json_t*);
+        STACK_POP(&frames, json_projection_frame_t);
+        get_c(reader);
+        goto next;
     }
     }
-    log_debug_msg("parsing success:" JSON_FORMAT(&value));
-    return value;
 error:
-    json_deinit(&key);
-    json_deinit(&elem);
     json_deinit(&value);
+    for (json_t** node; (node = STACK_TOP(&values, json_t*)) != NULL;) {
+        json_deinit(node);
+        STACK_POP(&values, json_t*);
+    }
+    json_stack_cleanup(&frames);
+    json_stack_cleanup(&values);
     return NULL;
 }
 
-json_t* json_init_from(json_getc_t getc, void* data)
+json_t* json_init_from_buf_projected(const char* data, size_t len, const char* const* paths, size_t count)
 {
     log_trace_func();
-    ASSERT_NULL(getc);
+    ASSERT_NULL(data);
+    ASSERT_NULL(paths);
     json_t* self = NULL;
-    reader_t reader = reader_init(getc, data);
-    self = CHECK_FUNC(json_parse(&reader));
+    json_parser_t parser;
+    memset(&parser, 0, sizeof(parser));
+    json_path_tree_t tree;
+    memset(&tree, 0, sizeof(tree));
+    CHECK_FUNC(json_path_tree_init(&tree, paths, count) == 0 ? &tree : NULL);
+    reader_t reader = reader_init_buf(&parser, data, len);
+    self = CHECK_FUNC(json_parse_projected(&reader, &tree));
+    skipspaces(&reader);
+    if (!reader.eof) {
+        log_error_msg("unexpected symbols after value at %zu", reader_tell(&reader));
+        json_deinit(&self);
+    }
 error:
-    reader_cleanup(&reader);
+    json_path_tree_cleanup(&tree);
+    json_parser_cleanup(&parser);
+    return self;
+}
+
+json_t* json_init_from_reader(json_read_t read, void* data)
+{
+    log_trace_func();
+    json_parser_t parser;
+    memset(&parser, 0, sizeof(parser));
+    json_t* self = json_parser_parse_reader(&parser, read, data);
+    json_parser_cleanup(&parser);
+    return self;
+}
+
+json_t* json_init_from_fd(int fd)
+{
+    log_trace_func();
+    if (fd < 0) {
+        log_error_msg("wrong fd %i", fd);
+        return NULL;
+    }
+    return CHECK_FUNC(json_init_from_reader((json_read_t)json_read_fd, &fd));
+error:
+    return NULL;
+}
+
+///
+///@brief Parse value from stream which can't be seeked (pipe, terminal) symbol by symbol
+/// \n Symbol ending number is returned to stream, so no symbols after value are taken
+///
+static json_t* json_init_from_stream(FILE* file)
+{
+    log_trace_func();
+    json_parser_t parser;
+    memset(&parser, 0, sizeof(parser));
+    reader_t reader = reader_init(&parser, (json_getc_t)json_get_c_file, file);
+    json_t* self = json_parse(&reader);
+    if (self != NULL && self->type == JSON_TYPE_NUMBER && cur_c(&reader) != '\0' && ungetc((unsigned char)cur_c(&reader), file) == EOF) {
+        log_debug_msg("can't return symbol to stream");
+    }
+    json_parser_cleanup(&parser);
     return self;
 }
 
@@ -1061,11 +3358,73 @@ json_t* json_init_from_file(FILE* file)
 {
     log_trace_func();
     ASSERT_NULL(file);
-    return CHECK_FUNC(json_init_from((json_getc_t)json_get_c_file, file));
+    if (ftell(file) < 0) {
+        log_debug_msg("stream is not seekable: %s(%i)", strerror(errno), errno);
+        return json_init_from_stream(file);
+    }
+    size_t consumed = 0;
+    json_parser_t parser;
+    memset(&parser, 0, sizeof(parser));
+    reader_t reader = reader_init_read(&parser, (json_read_t)json_read_file, file);
+    json_t* self = json_parse_counted(&reader, &consumed);
+    size_t unread = reader_taken(&reader) - consumed;
+    if (unread != 0 && fseek(file, -(long)unread, SEEK_CUR) != 0) {
+        log_debug_msg("can't return %zu symbols to stream: %s(%i)", unread, strerror(errno), errno);
+    }
+    json_parser_cleanup(&parser);
+    return self;
+}
+
+///
+///@brief Parse whole content of mapped file
+///
+static json_t* json_parse_mapped(const char* data, size_t len)
+{
+    log_trace_func();
+    size_t consumed = 0;
+    json_t* self = CHECK_FUNC(json_init_from_buf(data, len, &consumed));
+    if (scan_spaces(&data[consumed], &data[len]) != &data[len]) {
+        log_error_msg("unexpected symbols after value at %zu", consumed);
+        json_deinit(&self);
+    }
+    return self;
 error:
     return NULL;
 }
 
+json_t* json_init_from_path(const char* path)
+{
+    log_trace_func();
+    ASSERT_NULL(path);
+    log_debug_msg("path:'%s'", path);
+    json_t* self = NULL;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        log_error_msg("open(): %s(%i)", strerror(errno), errno);
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0) {
+        log_debug_msg("not mappable, read by blocks");
+        self = json_init_from_fd(fd);
+        close(fd);
+        return self;
+    }
+    size_t len = (size_t)info.st_size;
+    void* data = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        log_error_msg("mmap(): %s(%i)", strerror(errno), errno);
+        return NULL;
+    }
+    if (madvise(data, len, MADV_SEQUENTIAL) != 0) {
+        log_debug_msg("madvise(): %s(%i)", strerror(errno), errno);
+    }
+    self = json_parse_mapped(data, len);
+    munmap(data, len);
+    return self;
+}
+
 json_t* json_init_from_str(const char* str, const char** endptr)
 {
     log_trace_func();
@@ -1076,19 +3435,15 @@ json_t* json_init_from_str(const char* str, const char** endptr)
     }
     ASSERT_NULL(str);
     log_debug_msg("parse:\n%s", str);
-    json_t* self = json_init_from((json_getc_t)json_get_c_str, &str);
+    size_t consumed = 0;
+    json_parser_t parser;
+    memset(&parser, 0, sizeof(parser));
+    reader_t reader = reader_init_str(&parser, str);
+    json_t* self = json_parse_counted(&reader, &consumed);
+    json_parser_cleanup(&parser);
     if (endptr != NULL) {
-        if (self == NULL || json_get_type(&self) == JSON_NUMBER) {
-            str--;
-        }
-        log_debug_msg("%p", str);
-        *endptr = str;
+        *endptr = &str[consumed];
         log_debug_msg("endptr:'%s'", *endptr);
-    } else {
-        log_debug_msg("endptr is NULL");
-    }
-    if (self == NULL) {
-        log_error_msg("parsing error!");
     }
     return self;
-}
\ No newline at end of file
+}
@@ -1,59 +1,383 @@
 /// Copyright © Alexander Kaluzhnyy
 
 #include "log.h"
+#include <pthread.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdarg.h>
+#include <stddef.h>
+#include <time.h>
 
-static size_t indent_cnt = 0;
-static int state = 0;
+#define LOG_TEXT_SIZE 256
+#define LOG_LINE_SIZE 1024
+#define LOG_INDENT_MAX 64
+#define LOG_BATCH_SIZE (64 * 1024)
+#define LOG_RING_MIN_SIZE 64
+#define LOG_DRAIN_PERIOD_NS 1000000L
+#define LOG_CACHE_LINE 64
 
-static void log_indent(void)
+json_log_level_t json_log_current_level = JSON_LOG_ERROR;
+
+void json_log_set_level(json_log_level_t level)
+{
+    __atomic_store_n(&json_log_current_level, level, __ATOMIC_RELAXED);
+}
+
+json_log_level_t json_log_get_level(void)
+{
+    return __atomic_load_n(&json_log_current_level, __ATOMIC_RELAXED);
+}
+
+static void log_sink_stdout(void* data, const char* text, size_t len)
+{
+    (void)data;
+    fwrite(text, 1, len, stdout);
+    fflush(stdout);
+}
+
+static json_log_sink_t log_sink = log_sink_stdout;
+static void* log_sink_data = NULL;
+
+void json_log_set_sink(json_log_sink_t sink, void* data)
+{
+    log_sink = sink != NULL ? sink : log_sink_stdout;
+    log_sink_data = sink != NULL ? data : NULL;
+}
+
+typedef enum log_kind_t {
+    LOG_KIND_MSG,
+    LOG_KIND_ENTER,
+    LOG_KIND_EXIT,
+} log_kind_t;
+
+///
+///@brief Binary log record, written to line by log_format()
+/// \n Text of message is formatted by producer, its arguments may point to temporary memory.
+/// File and function are literals, they are kept by pointer.
+///
+typedef struct log_record_t {
+    size_t seq; ///< ring position slot is ready for: pos - for producer, pos + 1 - for consumer
+    log_kind_t kind;
+    size_t indent;
+    const char* file;
+    const char* function;
+    int line;
+    size_t len;
+    char text[LOG_TEXT_SIZE];
+} log_record_t;
+
+///
+///@brief Bounded lock-free MPSC ring of records drained by background thread
+/// \n Producers reserve slots by CAS of tail, records are dropped when ring is full,
+/// so logging threads never wait for drain thread.
+///
+typedef struct log_ring_t {
+    size_t mask;
+    pthread_t thread;
+    int stop;
+    __attribute__((aligned(LOG_CACHE_LINE))) size_t tail; ///< next position for producers
+    __attribute__((aligned(LOG_CACHE_LINE))) size_t head; ///< next position for drain thread
+    size_t dropped;
+    __attribute__((aligned(LOG_CACHE_LINE))) log_record_t records[];
+} log_ring_t;
+
+static log_ring_t* log_ring = NULL;
+// count of producers and flushes which may use ring, json_log_async_stop() waits for them before ring is freed
+static __attribute__((aligned(LOG_CACHE_LINE))) size_t log_inflight = 0;
+
+// indentation of nested calls is kept per thread
+static _Thread_local size_t indent_cnt = 0;
+
+static log_record_t* log_ring_reserve(log_ring_t* ring)
+{
+    size_t pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    for (;;) {
+        log_record_t* record = &ring->records[pos & ring->mask];
+        size_t seq = __atomic_load_n(&record->seq, __ATOMIC_ACQUIRE);
+        ptrdiff_t diff = (ptrdiff_t)(seq - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                return record;
+            }
+        } else if (diff < 0) {
+            // slot is not drained since previous lap
+            __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+            return NULL;
+        } else {
+            pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+///
+///@return length of line written to out, out should have LOG_LINE_SIZE symbols at least
+///
+static size_t log_format(const log_record_t* record, char* out)
+{
+    size_t indent = (record->indent < LOG_INDENT_MAX ? record->indent : LOG_INDENT_MAX) * 4;
+    memset(out, ' ', indent);
+    int len = 0;
+    switch (record->kind) {
+    case LOG_KIND_ENTER:
+        len = snprintf(out + indent, LOG_LINE_SIZE - indent, "%s(%s:%i){\n", record->function, record->file, record->line);
+        break;
+    case LOG_KIND_EXIT:
+        len = snprintf(out + indent, LOG_LINE_SIZE - indent, "}\n");
+        break;
+    default:
+        len = snprintf(out + indent, LOG_LINE_SIZE - indent, "%s:%i:%.*s\n", record->file, record->line, (int)record->len, record->text);
+        break;
+    }
+    if (len < 0) {
+        return 0;
+    }
+    if ((size_t)len >= LOG_LINE_SIZE - indent) {
+        out[LOG_LINE_SIZE - 2] = '\n';
+        return LOG_LINE_SIZE - 1;
+    }
+    return indent + (size_t)len;
+}
+
+///
+///@brief Write drained records to sink by batches
+///@return count of drained records
+///
+static size_t log_ring_drain(log_ring_t* ring)
+{
+    char batch[LOG_BATCH_SIZE];
+    size_t used = 0;
+    size_t count = 0;
+    size_t dropped = __atomic_exchange_n(&ring->dropped, 0, __ATOMIC_RELAXED);
+    if (dropped != 0) {
+        used += (size_t)snprintf(batch, LOG_LINE_SIZE, "log:%zu records dropped\n", dropped);
+    }
+    for (size_t head = ring->head;; head++) {
+        log_record_t* record = &ring->records[head & ring->mask];
+        if (__atomic_load_n(&record->seq, __ATOMIC_ACQUIRE) != head + 1) {
+            break;
+        }
+        if (LOG_BATCH_SIZE - used < LOG_LINE_SIZE) {
+            log_sink(log_sink_data, batch, used);
+            used = 0;
+        }
+        used += log_format(record, batch + used);
+        __atomic_store_n(&record->seq, head + ring->mask + 1, __ATOMIC_RELEASE);
+        __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+        count++;
+    }
+    if (used != 0) {
+        log_sink(log_sink_data, batch, used);
+    }
+    return count;
+}
+
+static void log_sleep(void)
+{
+    struct timespec period = { 0, LOG_DRAIN_PERIOD_NS };
+    nanosleep(&period, NULL);
+}
+
+static void* log_drain_thread(void* data)
+{
+    log_ring_t* ring = data;
+    for (;;) {
+        int stop = __atomic_load_n(&ring->stop, __ATOMIC_ACQUIRE);
+        if (log_ring_drain(ring) == 0) {
+            if (stop) {
+                break;
+            }
+            log_sleep();
+        }
+    }
+    return NULL;
+}
+
+int json_log_async_start(size_t capacity)
 {
-    for (size_t i = 0; i < indent_cnt; i++) {
-        putchar(' ');
-        putchar(' ');
-        putchar(' ');
-        putchar(' ');
+    if (__atomic_load_n(&log_ring, __ATOMIC_ACQUIRE) != NULL) {
+        return -1;
     }
+    size_t size = LOG_RING_MIN_SIZE;
+    while (size < capacity) {
+        size *= 2;
+    }
+    size_t bytes = (sizeof(log_ring_t) + size * sizeof(log_record_t) + LOG_CACHE_LINE - 1) & ~(size_t)(LOG_CACHE_LINE - 1);
+    log_ring_t* ring = aligned_alloc(LOG_CACHE_LINE, bytes);
+    if (ring == NULL) {
+        return -1;
+    }
+    memset(ring, 0, sizeof(log_ring_t));
+    ring->mask = size - 1;
+    for (size_t i = 0; i < size; i++) {
+        ring->records[i].seq = i;
+    }
+    if (pthread_create(&ring->thread, NULL, log_drain_thread, ring) != 0) {
+        free(ring);
+        return -1;
+    }
+    __atomic_store_n(&log_ring, ring, __ATOMIC_RELEASE);
+    return 0;
+}
+
+void json_log_async_stop(void)
+{
+    // sequentially consistent with producers: each of them either sees NULL or is counted
+    log_ring_t* ring = __atomic_exchange_n(&log_ring, NULL, __ATOMIC_SEQ_CST);
+    if (ring == NULL) {
+        return;
+    }
+    while (__atomic_load_n(&log_inflight, __ATOMIC_SEQ_CST) != 0) {
+        log_sleep();
+    }
+    __atomic_store_n(&ring->stop, 1, __ATOMIC_RELEASE);
+    pthread_join(ring->thread, NULL);
+    free(ring);
+}
+
+///
+///@brief Take ring for use, synchronous logging does not touch shared counter
+///@return ring counted in log_inflight till log_ring_release() or NULL when logging is synchronous
+///
+static log_ring_t* log_ring_acquire(void)
+{
+    if (__atomic_load_n(&log_ring, __ATOMIC_ACQUIRE) == NULL) {
+        return NULL;
+    }
+    // sequentially consistent with json_log_async_stop(): ring seen here is not freed till release
+    __atomic_fetch_add(&log_inflight, 1, __ATOMIC_SEQ_CST);
+    log_ring_t* ring = __atomic_load_n(&log_ring, __ATOMIC_SEQ_CST);
+    if (ring == NULL) {
+        __atomic_fetch_sub(&log_inflight, 1, __ATOMIC_RELEASE);
+    }
+    return ring;
+}
+
+static void log_ring_release(void)
+{
+    __atomic_fetch_sub(&log_inflight, 1, __ATOMIC_RELEASE);
+}
+
+void json_log_flush(void)
+{
+    log_ring_t* ring = log_ring_acquire();
+    if (ring == NULL) {
+        return;
+    }
+    size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    while ((ptrdiff_t)(__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - tail) < 0) {
+        log_sleep();
+    }
+    log_ring_release();
+}
+
+///
+///@return slot of ring, local record when logging is synchronous or NULL if record dropped
+/// \n Producer holding slot of ring is counted in log_inflight till log_record_end()
+///
+static log_record_t* log_record_begin(log_record_t* local, log_kind_t kind, const char* file, int line)
+{
+    log_ring_t* ring = log_ring_acquire();
+    log_record_t* record = local;
+    if (ring != NULL) {
+        record = log_ring_reserve(ring);
+        if (record == NULL) {
+            log_ring_release();
+        }
+    }
+    if (record != NULL) {
+        record->kind = kind;
+        record->indent = indent_cnt;
+        record->file = file;
+        record->line = line;
+        record->len = 0;
+    }
+    return record;
+}
+
+static void log_record_end(log_record_t* record, log_record_t* local)
+{
+    if (record != local) {
+        // publish slot for drain thread
+        __atomic_store_n(&record->seq, record->seq + 1, __ATOMIC_RELEASE);
+        log_ring_release();
+        return;
+    }
+    char line[LOG_LINE_SIZE];
+    log_sink(log_sink_data, line, log_format(record, line));
+}
+
+///
+///@brief Write message which does not fit to record directly to sink, it is not truncated
+///@return 0 - written, -1 - no memory for line
+///
+static int log_write_long(const log_record_t* record, size_t len, const char* format, va_list args)
+{
+    size_t indent = (record->indent < LOG_INDENT_MAX ? record->indent : LOG_INDENT_MAX) * 4;
+    char prefix[LOG_LINE_SIZE];
+    int prefix_len = snprintf(prefix, sizeof(prefix), "%s:%i:", record->file, record->line);
+    if (prefix_len < 0 || (size_t)prefix_len >= sizeof(prefix)) {
+        return -1;
+    }
+    size_t size = indent + (size_t)prefix_len + len + 1;
+    char* out = malloc(size + 1);
+    if (out == NULL) {
+        return -1;
+    }
+    memset(out, ' ', indent);
+    memcpy(out + indent, prefix, (size_t)prefix_len);
+    vsnprintf(out + indent + (size_t)prefix_len, len + 1, format, args);
+    out[size - 1] = '\n';
+    log_sink(log_sink_data, out, size);
+    free(out);
+    return 0;
 }
 
 void log_msg_internal(const char* file, int line, const char* format, ...)
 {
-    if (state == 0) {
-        putchar('\n');
-        state = 1;
+    log_record_t local;
+    log_record_t* record = log_record_begin(&local, LOG_KIND_MSG, file, line);
+    if (record == NULL) {
+        return;
     }
-    log_indent();
     va_list args;
-    printf("%s:%i:", file, line);
+    va_list copy;
     va_start(args, format);
-    vprintf(format, args);
-    putchar('\n');
-    state = 1;
-    fflush(stdout);
+    va_copy(copy, args);
+    int len = vsnprintf(record->text, LOG_TEXT_SIZE, format, args);
     va_end(args);
+    if (len >= LOG_TEXT_SIZE && record == &local && log_write_long(record, (size_t)len, format, copy) == 0) {
+        va_end(copy);
+        return;
+    }
+    va_end(copy);
+    record->len = len < 0 ? 0 : (size_t)len < LOG_TEXT_SIZE ? (size_t)len : LOG_TEXT_SIZE - 1;
+    if (len >= LOG_TEXT_SIZE) {
+        // record of ring has fixed size, truncation is marked
+        memcpy(&record->text[LOG_TEXT_SIZE - 4], "...", 3);
+    }
+    log_record_end(record, &local);
 }
+
 void log_trace_end(int* unused)
 {
     indent_cnt--;
-    if (state) {
-        log_indent();
+    log_record_t local;
+    log_record_t* record = log_record_begin(&local, LOG_KIND_EXIT, NULL, 0);
+    if (record != NULL) {
+        log_record_end(record, &local);
     }
-    putchar('}');
-    putchar('\n');
-    state = 1;
-    fflush(stdout);
     (void)unused;
 }
-void log_trace_start(const char* function, const char* file, int line)
+
+int log_trace_start(const char* function, const char* file, int line)
 {
-    if (state == 0) {
-        putchar('\n');
+    log_record_t local;
+    log_record_t* record = log_record_begin(&local, LOG_KIND_ENTER, file, line - 2);
+    if (record != NULL) {
+        record->function = function;
+        log_record_end(record, &local);
     }
-    log_indent();
-    printf("%s(%s:%i){", function, file, line - 2);
-    fflush(stdout);
-    state = 0;
     indent_cnt++;
+    return 1;
 }
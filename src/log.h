@@ -3,26 +3,62 @@
 #ifndef LOG_H_INCLUDED
 #define LOG_H_INCLUDED
 
+#include "json_log.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+extern json_log_level_t json_log_current_level;
+
 void log_msg_internal(const char* file, int line, const char* format, ...);
 void log_trace_end(int*);
-void log_trace_start(const char* function, const char* file, int line);
+int log_trace_start(const char* function, const char* file, int line);
 
 #define __LOG_FILE__ (&(strrchr("/" __FILE__, '/')[1]))
 
+///
+///@brief Check level before any formatting, one load and predictable branch
+/// \n Debug and trace are off by default, so the branch is expected not taken
+///
+#define log_enabled(level) __builtin_expect(__atomic_load_n(&json_log_current_level, __ATOMIC_RELAXED) >= (level), 0)
+
+#ifdef JSON_NO_LOG
+// arguments are kept referenced but never evaluated, so compiler drops them
+#define log_debug_enabled() 0
+#else
+#define log_debug_enabled() log_enabled(JSON_LOG_DEBUG)
+#endif
+
 #define log_msg(format, ...) log_msg_internal(__LOG_FILE__, __LINE__, format, ##__VA_ARGS__)
 
-#define log_error_msg(format, ...) log_msg("error:" format, ##__VA_ARGS__)
+#define log_error_msg(format, ...) ({            \
+    if (log_enabled(JSON_LOG_ERROR)) {           \
+        log_msg("error:" format, ##__VA_ARGS__); \
+    }                                            \
+})
+
+#define log_debug_msg(format, ...) ({            \
+    if (log_debug_enabled()) {                   \
+        log_msg("debug:" format, ##__VA_ARGS__); \
+    }                                            \
+})
 
-#define log_debug_msg(format, ...) log_msg("debug:" format, ##__VA_ARGS__)
+static inline void log_trace_cleanup(int* started)
+{
+    if (__builtin_expect(*started, 0)) {
+        log_trace_end(started);
+    }
+}
 
-#define log_trace_func()                                            \
-    __attribute__((cleanup(log_trace_end))) int log_trace_func_var; \
-    (void)log_trace_func_var;                                       \
-    log_trace_start(__FUNCTION__, __LOG_FILE__, __LINE__)
+#ifdef JSON_NO_LOG
+#define log_trace_func() ((void)0)
+#else
+#define log_trace_func()                                                                      \
+    __attribute__((cleanup(log_trace_cleanup))) int log_trace_func_var =                      \
+        log_enabled(JSON_LOG_TRACE) && log_trace_start(__FUNCTION__, __LOG_FILE__, __LINE__); \
+    (void)log_trace_func_var
+#endif
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,454 @@
+/// Copyright © Alexander Kaluzhnyy
+
+#include "json.h"
+#include "json_ndjson.h"
+#include "json_parser.h"
+#include "log.h"
+#include "scan.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NDJSON_MIN_BATCH_SIZE 1024
+#define NDJSON_BATCH_SIZE (256 * 1024)
+#define NDJSON_SLOTS_PER_THREAD 4
+
+typedef struct ndjson_record_t {
+    size_t line;
+    json_t* value;
+} ndjson_record_t;
+
+typedef enum ndjson_slot_state_t {
+    NDJSON_SLOT_FREE, ///< may be filled by input
+    NDJSON_SLOT_READY, ///< filled, waits for worker
+    NDJSON_SLOT_BUSY, ///< parsed by worker
+    NDJSON_SLOT_DONE, ///< parsed, waits for delivery
+} ndjson_slot_state_t;
+
+///
+///@brief Batch of input lines parsed by one worker at once
+///
+typedef struct ndjson_slot_t {
+    ndjson_slot_state_t state;
+    size_t seq;
+    const char* data;
+    size_t len;
+    size_t first_line;
+    struct {
+        char* data;
+        size_t size;
+    } block;
+    ndjson_record_t* records;
+    size_t count;
+    size_t capacity;
+    int error;
+} ndjson_slot_t;
+
+typedef struct ndjson_source_t {
+    const char* data;
+    size_t len;
+    size_t pos;
+    FILE* file;
+    size_t batch;
+    struct {
+        char* data;
+        size_t stored;
+        size_t size;
+    } tail;
+    size_t line;
+} ndjson_source_t;
+
+typedef struct ndjson_pool_t {
+    pthread_mutex_t lock;
+    pthread_cond_t work;
+    pthread_cond_t done;
+    ndjson_slot_t* slots;
+    size_t slots_cnt;
+    size_t next_parse;
+    size_t next_fill;
+    int stop;
+    pthread_t* threads;
+    size_t threads_cnt;
+} ndjson_pool_t;
+
+static int ndjson_is_blank(const char* pos, size_t len)
+{
+    const char* end = pos + len;
+    return scan_spaces(pos, end) == end;
+}
+
+static int ndjson_slot_add(ndjson_slot_t* slot, size_t line, json_t* value)
+{
+    if (slot->count == slot->capacity) {
+        size_t capacity = slot->capacity ? slot->capacity * 2 : 64;
+        ndjson_record_t* records = realloc(slot->records, capacity * sizeof(ndjson_record_t));
+        if (records == NULL) {
+            log_error_msg("realloc(): %s(%i)", strerror(errno), errno);
+            return -1;
+        }
+        slot->records = records;
+        slot->capacity = capacity;
+    }
+    slot->records[slot->count++] = (ndjson_record_t) { line, value };
+    return 0;
+}
+
+static void ndjson_parse_slot(json_parser_t* parser, ndjson_slot_t* slot)
+{
+    log_trace_func();
+    size_t line = slot->first_line;
+    const char* end = slot->data + slot->len;
+    for (const char* pos = slot->data; pos < end; line++) {
+        const char* eol = memchr(pos, '\n', (size_t)(end - pos));
+        size_t len = (size_t)((eol != NULL ? eol : end) - pos);
+        if (!ndjson_is_blank(pos, len)) {
+            size_t consumed = 0;
+            json_t* value = json_parser_parse_buf(parser, pos, len, &consumed);
+            if (value != NULL && !ndjson_is_blank(pos + consumed, len - consumed)) {
+                log_error_msg("unexpected symbols after value in line %zu", line);
+                json_deinit(&value);
+            }
+            if (ndjson_slot_add(slot, line, value) != 0) {
+                if (value != NULL) {
+                    json_deinit(&value);
+                }
+                slot->error = 1;
+                return;
+            }
+        }
+        pos += len + 1;
+    }
+}
+
+static ndjson_slot_t* ndjson_find_slot(ndjson_pool_t* pool, ndjson_slot_state_t state, const size_t* seq)
+{
+    ndjson_slot_t* found = NULL;
+    for (size_t i = 0; i < pool->slots_cnt; i++) {
+        ndjson_slot_t* slot = &pool->slots[i];
+        if (slot->state != state || (seq != NULL && slot->seq != *seq)) {
+            continue;
+        }
+        if (found == NULL || slot->seq < found->seq) {
+            found = slot;
+        }
+    }
+    return found;
+}
+
+static void* ndjson_worker(void* arg)
+{
+    log_trace_func();
+    ndjson_pool_t* pool = arg;
+    json_parser_t* parser = json_parser_init();
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        ndjson_slot_t* slot = ndjson_find_slot(pool, NDJSON_SLOT_READY, &pool->next_parse);
+        if (slot == NULL) {
+            if (pool->stop) {
+                break;
+            }
+            pthread_cond_wait(&pool->work, &pool->lock);
+            continue;
+        }
+        pool->next_parse++;
+        slot->state = NDJSON_SLOT_BUSY;
+        pthread_mutex_unlock(&pool->lock);
+        if (parser != NULL) {
+            ndjson_parse_slot(parser, slot);
+        } else {
+            slot->error = 1;
+        }
+        pthread_mutex_lock(&pool->lock);
+        slot->state = NDJSON_SLOT_DONE;
+        pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    if (parser != NULL) {
+        json_parser_deinit(&parser);
+    }
+    return NULL;
+}
+
+static size_t ndjson_count_lines(const char* pos, size_t len)
+{
+    size_t count = 0;
+    const char* end = pos + len;
+    while ((pos = memchr(pos, '\n', (size_t)(end - pos))) != NULL) {
+        count++;
+        pos++;
+    }
+    return count;
+}
+
+///
+///@brief Fill slot by lines from buffer
+///@return 1 - filled, 0 - end of input
+///
+static int ndjson_fill_buf(ndjson_source_t* source, ndjson_slot_t* slot)
+{
+    if (source->pos == source->len) {
+        return 0;
+    }
+    size_t end = source->len - source->pos > source->batch ? source->pos + source->batch : source->len;
+    const char* eol = memchr(&source->data[end], '\n', source->len - end);
+    end = eol != NULL ? (size_t)(eol - source->data) + 1 : source->len;
+    slot->data = &source->data[source->pos];
+    slot->len = end - source->pos;
+    source->pos = end;
+    return 1;
+}
+
+static int ndjson_reserve(char** data, size_t* size, size_t required)
+{
+    if (*size >= required) {
+        return 0;
+    }
+    size_t new_size = *size ? *size * 2 : NDJSON_MIN_BATCH_SIZE;
+    while (new_size < required) {
+        new_size *= 2;
+    }
+    char* new_data = realloc(*data, new_size);
+    if (new_data == NULL) {
+        log_error_msg("realloc(): %s(%i)", strerror(errno), errno);
+        return -1;
+    }
+    *data = new_data;
+    *size = new_size;
+    return 0;
+}
+
+///
+///@brief Fill slot by whole lines read from file, rest of last line kept for next slot
+///@return 1 - filled, 0 - end of input, -1 - error
+///
+static int ndjson_fill_file(ndjson_source_t* source, ndjson_slot_t* slot)
+{
+    size_t len = source->tail.stored;
+    if (ndjson_reserve(&slot->block.data, &slot->block.size, len + source->batch) != 0) {
+        return -1;
+    }
+    if (len != 0) {
+        memcpy(slot->block.data, source->tail.data, len);
+    }
+    size_t lines_end = 0;
+    int eof = 0;
+    while (lines_end == 0 && !eof) {
+        if (ndjson_reserve(&slot->block.data, &slot->block.size, len + source->batch) != 0) {
+            return -1;
+        }
+        size_t ret = fread(&slot->block.data[len], sizeof(char), source->batch, source->file);
+        if (ret < source->batch) {
+            if (ferror(source->file)) {
+                log_error_msg("fread(): %s(%i)", strerror(errno), errno);
+                return -1;
+            }
+            eof = 1;
+        }
+        for (size_t i = len + ret; i > len; i--) {
+            if (slot->block.data[i - 1] == '\n') {
+                lines_end = i;
+                break;
+            }
+        }
+        len += ret;
+    }
+    if (eof) {
+        lines_end = len;
+    }
+    if (lines_end == 0) {
+        return 0;
+    }
+    source->tail.stored = 0;
+    if (ndjson_reserve(&source->tail.data, &source->tail.size, len - lines_end) != 0) {
+        return -1;
+    }
+    memcpy(source->tail.data, &slot->block.data[lines_end], len - lines_end);
+    source->tail.stored = len - lines_end;
+    slot->data = slot->block.data;
+    slot->len = lines_end;
+    return 1;
+}
+
+static void ndjson_slot_drop(ndjson_slot_t* slot)
+{
+    for (size_t i = 0; i < slot->count; i++) {
+        if (slot->records[i].value != NULL) {
+            json_deinit(&slot->records[i].value);
+        }
+    }
+    slot->count = 0;
+}
+
+///
+///@brief Deliver records of slot to callback
+///@return 0 - continue, -1 - stop reading
+///
+static int ndjson_deliver(ndjson_slot_t* slot, json_ndjson_callback_t callback, void* user_data)
+{
+    log_trace_func();
+    int ret = slot->error ? -1 : 0;
+    for (size_t i = 0; i < slot->count && ret == 0; i++) {
+        json_t* value = slot->records[i].value;
+        slot->records[i].value = NULL;
+        if (callback(user_data, slot->records[i].line, value) != 0) {
+            log_debug_msg("stopped by callback at line %zu", slot->records[i].line);
+            ret = -1;
+        }
+    }
+    ndjson_slot_drop(slot);
+    slot->error = 0;
+    return ret;
+}
+
+static int ndjson_pool_init(ndjson_pool_t* pool, size_t threads)
+{
+    log_trace_func();
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (size_t)cpus : 1;
+    }
+    log_debug_msg("threads:%zu", threads);
+    memset(pool, 0, sizeof(*pool));
+    pool->slots_cnt = threads * NDJSON_SLOTS_PER_THREAD;
+    pool->slots = calloc(pool->slots_cnt, sizeof(ndjson_slot_t));
+    pool->threads = calloc(threads, sizeof(pthread_t));
+    if (pool->slots == NULL || pool->threads == NULL) {
+        log_error_msg("calloc(): %s(%i)", strerror(errno), errno);
+        goto error;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    for (; pool->threads_cnt < threads; pool->threads_cnt++) {
+        int ret = pthread_create(&pool->threads[pool->threads_cnt], NULL, ndjson_worker, pool);
+        if (ret != 0) {
+            log_error_msg("pthread_create(): %s(%i)", strerror(ret), ret);
+            break;
+        }
+    }
+    if (pool->threads_cnt == 0) {
+        pthread_cond_destroy(&pool->done);
+        pthread_cond_destroy(&pool->work);
+        pthread_mutex_destroy(&pool->lock);
+        goto error;
+    }
+    return 0;
+error:
+    free(pool->threads);
+    free(pool->slots);
+    return -1;
+}
+
+static void ndjson_pool_deinit(ndjson_pool_t* pool)
+{
+    log_trace_func();
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+    for (size_t i = 0; i < pool->threads_cnt; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    for (size_t i = 0; i < pool->slots_cnt; i++) {
+        ndjson_slot_drop(&pool->slots[i]);
+        free(pool->slots[i].records);
+        free(pool->slots[i].block.data);
+    }
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->threads);
+    free(pool->slots);
+}
+
+///
+///@brief Fill free slots from source, deliver parsed ones till end of input
+///
+static int ndjson_run(ndjson_source_t* source, size_t threads, int ordered, json_ndjson_callback_t callback, void* user_data)
+{
+    log_trace_func();
+    ndjson_pool_t pool;
+    if (ndjson_pool_init(&pool, threads) != 0) {
+        return -1;
+    }
+    int ret = 0;
+    int input_end = 0;
+    size_t next_deliver = 0;
+    pthread_mutex_lock(&pool.lock);
+    for (;;) {
+        ndjson_slot_t* slot = NULL;
+        if (!input_end && ret == 0 && (slot = ndjson_find_slot(&pool, NDJSON_SLOT_FREE, NULL)) != NULL) {
+            pthread_mutex_unlock(&pool.lock);
+            int filled = source->file != NULL ? ndjson_fill_file(source, slot) : ndjson_fill_buf(source, slot);
+            if (filled > 0) {
+                slot->first_line = source->line;
+                source->line += ndjson_count_lines(slot->data, slot->len);
+                // small batches first, so small input is parsed by several threads too
+                source->batch = source->batch < NDJSON_BATCH_SIZE ? source->batch * 2 : NDJSON_BATCH_SIZE;
+            }
+            pthread_mutex_lock(&pool.lock);
+            if (filled > 0) {
+                slot->seq = pool.next_fill++;
+                slot->state = NDJSON_SLOT_READY;
+                pthread_cond_signal(&pool.work);
+            } else {
+                input_end = 1;
+                ret = filled < 0 ? -1 : ret;
+            }
+            continue;
+        }
+        slot = ndjson_find_slot(&pool, NDJSON_SLOT_DONE, ordered ? &next_deliver : NULL);
+        if (slot != NULL) {
+            next_deliver++;
+            pthread_mutex_unlock(&pool.lock);
+            if (ret == 0) {
+                ret = ndjson_deliver(slot, callback, user_data);
+            } else {
+                ndjson_slot_drop(slot);
+            }
+            pthread_mutex_lock(&pool.lock);
+            slot->state = NDJSON_SLOT_FREE;
+            continue;
+        }
+        if ((input_end || ret != 0) && next_deliver == pool.next_fill) {
+            break;
+        }
+        pthread_cond_wait(&pool.done, &pool.lock);
+    }
+    pthread_mutex_unlock(&pool.lock);
+    ndjson_pool_deinit(&pool);
+    return ret;
+}
+
+int json_ndjson_parse_buf(const char* data, size_t len, size_t threads, int ordered, json_ndjson_callback_t callback, void* user_data)
+{
+    log_trace_func();
+    if (data == NULL || callback == NULL) {
+        log_error_msg("data or callback is NULL");
+        return -1;
+    }
+    ndjson_source_t source;
+    memset(&source, 0, sizeof(source));
+    source.data = data;
+    source.len = len;
+    source.batch = NDJSON_MIN_BATCH_SIZE;
+    return ndjson_run(&source, threads, ordered, callback, user_data);
+}
+
+int json_ndjson_parse_file(FILE* file, size_t threads, int ordered, json_ndjson_callback_t callback, void* user_data)
+{
+    log_trace_func();
+    if (file == NULL || callback == NULL) {
+        log_error_msg("file or callback is NULL");
+        return -1;
+    }
+    ndjson_source_t source;
+    memset(&source, 0, sizeof(source));
+    source.file = file;
+    source.batch = NDJSON_MIN_BATCH_SIZE;
+    int ret = ndjson_run(&source, threads, ordered, callback, user_data);
+    free(source.tail.data);
+    return ret;
+}
@@ -0,0 +1,256 @@
+/// Copyright © Alexander Kaluzhnyy
+
+#include "pool.h"
+#include "log.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define POOL_SLAB_SIZE (64 * 1024)
+#define POOL_ALIGN 16
+#define POOL_CLASS_COUNT 8
+#define POOL_BATCH 32
+#define POOL_CACHE_MAX (POOL_BATCH * 2)
+
+static const size_t pool_class_size[POOL_CLASS_COUNT] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+
+typedef struct pool_block_t {
+    struct pool_block_t* next;
+} pool_block_t;
+
+///
+///@brief Header of slab, slab is aligned by POOL_SLAB_SIZE and cut into blocks of one class
+/// \n Class of slab is not changed till slab is returned to system, so it is read without lock.
+///
+typedef struct pool_slab_t {
+    struct pool_slab_t* next;
+    size_t class_id;
+    size_t count; ///< count of blocks in slab
+    size_t free_cnt; ///< blocks in shared free list, slab is not used when all blocks are there
+} pool_slab_t;
+
+_Static_assert(sizeof(pool_slab_t) % POOL_ALIGN == 0, "blocks of slab are not aligned");
+
+///
+///@brief Shared free blocks and slabs of size class, protected by pool_mutex
+///
+typedef struct pool_class_t {
+    pool_block_t* free;
+    pool_slab_t* slabs;
+} pool_class_t;
+
+///
+///@brief Free blocks of thread, returned to shared lists by batches
+///
+typedef struct pool_cache_t {
+    pool_block_t* free[POOL_CLASS_COUNT];
+    size_t count[POOL_CLASS_COUNT];
+    int registered; ///< cache is flushed on thread exit
+    int exited; ///< cache is flushed by thread exit, blocks are passed to shared lists directly
+} pool_cache_t;
+
+static pool_class_t pool_classes[POOL_CLASS_COUNT];
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t pool_key;
+static pthread_once_t pool_key_once = PTHREAD_ONCE_INIT;
+static int pool_enabled = 0;
+static _Thread_local pool_cache_t pool_cache;
+
+void json_pool_set_enabled(int enable)
+{
+    __atomic_store_n(&pool_enabled, enable != 0, __ATOMIC_RELAXED);
+}
+
+int json_pool_enabled(void)
+{
+    return __atomic_load_n(&pool_enabled, __ATOMIC_RELAXED);
+}
+
+static pool_slab_t* pool_slab_of(const void* ptr)
+{
+    return (pool_slab_t*)((uintptr_t)ptr & ~(uintptr_t)(POOL_SLAB_SIZE - 1));
+}
+
+///
+///@brief Move up to count blocks of class from cache to shared list, pool_mutex is locked
+///
+static void pool_cache_put(pool_cache_t* cache, size_t class_id, size_t count)
+{
+    for (; count > 0 && cache->free[class_id] != NULL; count--) {
+        pool_block_t* block = cache->free[class_id];
+        cache->free[class_id] = block->next;
+        cache->count[class_id]--;
+        block->next = pool_classes[class_id].free;
+        pool_classes[class_id].free = block;
+        pool_slab_of(block)->free_cnt++;
+    }
+}
+
+static void pool_cache_flush(void* data)
+{
+    pool_cache_t* cache = data;
+    pthread_mutex_lock(&pool_mutex);
+    for (size_t class_id = 0; class_id < POOL_CLASS_COUNT; class_id++) {
+        pool_cache_put(cache, class_id, SIZE_MAX);
+    }
+    pthread_mutex_unlock(&pool_mutex);
+}
+
+///
+///@brief Destructor of thread key, frees done later by destructors of other keys bypass cache
+///
+static void pool_cache_exit(void* data)
+{
+    pool_cache_t* cache = data;
+    pool_cache_flush(cache);
+    cache->exited = 1;
+}
+
+static void pool_key_create(void)
+{
+    pthread_key_create(&pool_key, pool_cache_exit);
+}
+
+///
+///@brief Cache of calling thread, it is registered for flush on thread exit on first use
+///
+static pool_cache_t* pool_cache_get(void)
+{
+    pool_cache_t* cache = &pool_cache;
+    if (!cache->registered) {
+        pthread_once(&pool_key_once, pool_key_create);
+        pthread_setspecific(pool_key, cache);
+        cache->registered = 1;
+    }
+    return cache;
+}
+
+///
+///@brief Cut new slab into blocks of shared list, pool_mutex is locked
+///
+static int pool_slab_add(size_t class_id)
+{
+    pool_slab_t* slab = aligned_alloc(POOL_SLAB_SIZE, POOL_SLAB_SIZE);
+    if (slab == NULL) {
+        log_error_msg("aligned_alloc(): %s(%i)", strerror(errno), errno);
+        return -1;
+    }
+    size_t size = pool_class_size[class_id];
+    slab->class_id = class_id;
+    slab->count = (POOL_SLAB_SIZE - sizeof(pool_slab_t)) / size;
+    slab->free_cnt = slab->count;
+    slab->next = pool_classes[class_id].slabs;
+    pool_classes[class_id].slabs = slab;
+    for (size_t i = slab->count; i > 0; i--) {
+        pool_block_t* block = (pool_block_t*)((char*)(slab + 1) + (i - 1) * size);
+        block->next = pool_classes[class_id].free;
+        pool_classes[class_id].free = block;
+    }
+    return 0;
+}
+
+///
+///@brief Take batch of blocks from shared list into cache
+///
+static int pool_cache_refill(pool_cache_t* cache, size_t class_id)
+{
+    pthread_mutex_lock(&pool_mutex);
+    if (pool_classes[class_id].free == NULL && pool_slab_add(class_id) != 0) {
+        pthread_mutex_unlock(&pool_mutex);
+        return -1;
+    }
+    for (size_t i = 0; i < POOL_BATCH && pool_classes[class_id].free != NULL; i++) {
+        pool_block_t* block = pool_classes[class_id].free;
+        pool_classes[class_id].free = block->next;
+        pool_slab_of(block)->free_cnt--;
+        block->next = cache->free[class_id];
+        cache->free[class_id] = block;
+        cache->count[class_id]++;
+    }
+    pthread_mutex_unlock(&pool_mutex);
+    return 0;
+}
+
+void* json_pool_alloc(size_t size)
+{
+    size_t class_id = 0;
+    while (class_id < POOL_CLASS_COUNT && pool_class_size[class_id] < size) {
+        class_id++;
+    }
+    if (class_id == POOL_CLASS_COUNT) {
+        return NULL;
+    }
+    pool_cache_t* cache = pool_cache_get();
+    if (cache->exited) {
+        pthread_mutex_lock(&pool_mutex);
+        pool_block_t* block = NULL;
+        if (pool_classes[class_id].free != NULL || pool_slab_add(class_id) == 0) {
+            block = pool_classes[class_id].free;
+            pool_classes[class_id].free = block->next;
+            pool_slab_of(block)->free_cnt--;
+        }
+        pthread_mutex_unlock(&pool_mutex);
+        return block != NULL ? memset(block, 0, pool_class_size[class_id]) : NULL;
+    }
+    if (cache->free[class_id] == NULL && pool_cache_refill(cache, class_id) != 0) {
+        return NULL;
+    }
+    pool_block_t* block = cache->free[class_id];
+    cache->free[class_id] = block->next;
+    cache->count[class_id]--;
+    return memset(block, 0, pool_class_size[class_id]);
+}
+
+void json_pool_free(void* ptr)
+{
+    pool_cache_t* cache = pool_cache_get();
+    size_t class_id = pool_slab_of(ptr)->class_id;
+    pool_block_t* block = ptr;
+    block->next = cache->free[class_id];
+    cache->free[class_id] = block;
+    if (++cache->count[class_id] > POOL_CACHE_MAX || cache->exited) {
+        pthread_mutex_lock(&pool_mutex);
+        pool_cache_put(cache, class_id, cache->exited ? SIZE_MAX : POOL_BATCH);
+        pthread_mutex_unlock(&pool_mutex);
+    }
+}
+
+size_t json_pool_block_size(const void* ptr)
+{
+    return pool_class_size[pool_slab_of(ptr)->class_id];
+}
+
+size_t json_pool_trim(void)
+{
+    log_trace_func();
+    size_t bytes = 0;
+    pool_cache_flush(&pool_cache);
+    pthread_mutex_lock(&pool_mutex);
+    for (size_t class_id = 0; class_id < POOL_CLASS_COUNT; class_id++) {
+        pool_class_t* pool = &pool_classes[class_id];
+        // blocks of unused slabs are dropped from free list before slabs are released
+        for (pool_block_t** block = &pool->free; *block != NULL;) {
+            pool_slab_t* slab = pool_slab_of(*block);
+            if (slab->free_cnt == slab->count) {
+                *block = (*block)->next;
+            } else {
+                block = &(*block)->next;
+            }
+        }
+        for (pool_slab_t** slab = &pool->slabs; *slab != NULL;) {
+            if ((*slab)->free_cnt == (*slab)->count) {
+                pool_slab_t* unused = *slab;
+                *slab = unused->next;
+                free(unused);
+                bytes += POOL_SLAB_SIZE;
+            } else {
+                slab = &(*slab)->next;
+            }
+        }
+    }
+    pthread_mutex_unlock(&pool_mutex);
+    log_debug_msg("%zu bytes returned", bytes);
+    return bytes;
+}
@@ -0,0 +1,36 @@
+/// Copyright © Alexander Kaluzhnyy
+
+#ifndef POOL_H_INCLUDED
+#define POOL_H_INCLUDED
+
+#include "json_pool.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+///
+///@return 1 if nodes should be allocated by json_pool_alloc()
+///
+int json_pool_enabled(void);
+///
+///@brief Allocate zero filled block of size class fitting size from pool of calling thread
+///@return pointer aligned for any type. NULL if size is bigger than largest class
+/// or in case of allocation error
+///
+void* json_pool_alloc(size_t size);
+///
+///@brief Return block of json_pool_alloc() to pool of calling thread
+///
+void json_pool_free(void* ptr);
+///
+///@return size of block of json_pool_alloc(), it may be more than requested
+///
+size_t json_pool_block_size(const void* ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POOL_H_INCLUDED
@@ -6,6 +6,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "log.h"
+#include "stack.h"
 #include <errno.h>
 
 typedef struct writer_t {
@@ -72,11 +73,11 @@ static int put_s(writer_t* writer, const char* s)
 }
 #define PUT_S(writer, s) HANDLE_ERROR(put_s(writer, s), "can't put '%s'", s)
 
-static int put_json_s(writer_t* writer, const char* str)
+static int put_json_s(writer_t* writer, const char* str, size_t len)
 {
     log_trace_func();
     PUT_C(writer, '"');
-    for (size_t i = 0; str[i] != '\0'; i++) {
+    for (size_t i = 0; i < len; i++) {
         switch (str[i]) {
         case '"':
         case '\\':
@@ -89,7 +90,7 @@ static int put_json_s(writer_t* writer, const char* str)
     return PUT_C(writer, '"');
 }
 
-#define PUT_JSON_S(writer, s) HANDLE_ERROR(put_json_s(writer, s), "can't put '%s'", s)
+#define PUT_JSON_S(writer, s, len) HANDLE_ERROR(put_json_s(writer, s, len), "can't put '%.*s'", (int)(len), s)
 
 static int put_indent(writer_t* writer, int change)
 {
@@ -110,47 +111,86 @@ static int put_indent(writer_t* writer, int change)
 #define PUT_INDENT_ADD(writer) HANDLE_ERROR(put_indent(writer, 1), "can't put indent")
 #define PUT_INDENT_SUB(writer) HANDLE_ERROR(put_indent(writer, -1), "can't put indent")
 
-#define JSON_GET_STR(self) HANDLE_NULL_ERROR(json_get_str(self), "json_get_str() return NULL")
+#define JSON_GET_STRN(self, len) HANDLE_NULL_ERROR(json_get_strn(self, len), "json_get_strn() return NULL")
 #define JSON_KEY(self, id) HANDLE_NULL_ERROR(json_key(self, id), "json_key() return NULL")
 #define JSON_GET_BY_ID(self, id) HANDLE_NULL_ERROR(json_get_by_id(self, id), "json_get_by_id() return NULL")
 
-static int json_print_internal(json_t** self, writer_t* writer)
+typedef struct print_frame_t {
+    json_t** node;
+    size_t id;
+} print_frame_t;
+
+static int json_print_value(json_t** self, writer_t* writer)
 {
     log_trace_func();
     log_debug_msg(JSON_FORMAT(self));
     const char* type = json_get_type(self);
     if (type != JSON_OBJECT && type != JSON_ARRAY) {
         log_debug_msg("Object not container. Get only value");
-        const char* value = JSON_GET_STR(self);
+        size_t len = 0;
+        const char* value = JSON_GET_STRN(self, &len);
         if (type == JSON_STRING) {
-            return PUT_JSON_S(writer, value);
+            return PUT_JSON_S(writer, value, len);
         }
         return PUT_S(writer, value);
-    } else {
-        const char* border = type == JSON_OBJECT ? "{}" : "[]";
-        PUT_C(writer, border[0]);
-        PUT_INDENT_ADD(writer);
-        for (size_t i = 0; i < json_size(self); i++) {
-            if (i != 0) {
+    }
+    PUT_C(writer, type == JSON_OBJECT ? '{' : '[');
+    PUT_INDENT_ADD(writer);
+    return 0;
+}
+
+///
+///@brief Print value without recursion. Containers in progress stored on stack
+///
+static int json_print_walk(json_t** self, writer_t* writer, json_stack_t* stack)
+{
+    log_trace_func();
+    for (json_t** node = self; node != NULL;) {
+        if (json_print_value(node, writer) != 0) {
+            log_error_msg("json_print_value() return error");
+            return -1;
+        }
+        const char* type = json_get_type(node);
+        if (type == JSON_OBJECT || type == JSON_ARRAY) {
+            print_frame_t* frame = HANDLE_NULL_ERROR(STACK_PUSH(stack, print_frame_t), "can't push frame");
+            frame->node = node;
+            frame->id = 0;
+        }
+        node = NULL;
+        for (print_frame_t* frame; node == NULL && (frame = STACK_TOP(stack, print_frame_t)) != NULL;) {
+            type = json_get_type(frame->node);
+            if (frame->id == json_size(frame->node)) {
+                PUT_INDENT_SUB(writer);
+                PUT_C(writer, type == JSON_OBJECT ? '}' : ']');
+                STACK_POP(stack, print_frame_t);
+                continue;
+            }
+            if (frame->id != 0) {
                 PUT_C(writer, ',');
             }
             PUT_INDENT(writer);
             if (type == JSON_OBJECT) {
-                PUT_JSON_S(writer, JSON_KEY(self, i));
+                const char* key = JSON_KEY(frame->node, frame->id);
+                PUT_JSON_S(writer, key, strlen(key));
                 PUT_C(writer, ':');
             }
-            json_t** node = JSON_GET_BY_ID(self, i);
-            if (json_print_internal(node, writer) != 0) {
-                log_error_msg("json_print_internal() return error");
-                return -1;
-            }
+            node = JSON_GET_BY_ID(frame->node, frame->id);
+            frame->id++;
         }
-        PUT_INDENT_SUB(writer);
-        PUT_C(writer, border[1]);
     }
     return 0;
 }
 
+static int json_print_internal(json_t** self, writer_t* writer)
+{
+    log_trace_func();
+    json_stack_t stack;
+    memset(&stack, 0, sizeof(stack));
+    int ret = json_print_walk(self, writer, &stack);
+    json_stack_cleanup(&stack);
+    return ret;
+}
+
 ssize_t json_uniprint(json_t** self, size_t indent, json_putchar_t putchar, void* data)
 {
     log_trace_func();
@@ -0,0 +1,157 @@
+/// Copyright © Alexander Kaluzhnyy
+
+#include "scan.h"
+#include "log.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SCAN_X86
+#include <immintrin.h>
+#endif
+
+const unsigned char scan_space_table[256] = {
+    [' '] = 1,
+    ['\t'] = 1,
+    ['\n'] = 1,
+    ['\v'] = 1,
+    ['\f'] = 1,
+    ['\r'] = 1,
+};
+
+static const char* scan_spaces_scalar(const char* pos, const char* end)
+{
+    while (pos < end && scan_isspace(*pos)) {
+        pos++;
+    }
+    return pos;
+}
+
+#define scan_isplain(c) ((unsigned char)(c) >= 0x20 && (c) != '"' && (c) != '\\')
+
+static const char* scan_string_scalar(const char* pos, const char* end)
+{
+    while (pos < end && scan_isplain(*pos)) {
+        pos++;
+    }
+    return pos;
+}
+
+static const scan_impl_t scan_scalar = {
+    .name = "scalar",
+    .spaces = scan_spaces_scalar,
+    .string = scan_string_scalar,
+};
+
+#ifdef SCAN_X86
+
+static const char* scan_spaces_sse2(const char* pos, const char* end)
+{
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i ctrl_low = _mm_set1_epi8('\t' - 1);
+    const __m128i ctrl_high = _mm_set1_epi8('\r' + 1);
+    for (; end - pos >= 16; pos += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)pos);
+        __m128i is_ctrl = _mm_and_si128(_mm_cmpgt_epi8(block, ctrl_low), _mm_cmplt_epi8(block, ctrl_high));
+        __m128i is_space = _mm_or_si128(_mm_cmpeq_epi8(block, space), is_ctrl);
+        unsigned mask = ~(unsigned)_mm_movemask_epi8(is_space) & 0xFFFF;
+        if (mask != 0) {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    return scan_spaces_scalar(pos, end);
+}
+
+static const char* scan_string_sse2(const char* pos, const char* end)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i slash = _mm_set1_epi8('\\');
+    const __m128i ctrl_max = _mm_set1_epi8(0x1F);
+    for (; end - pos >= 16; pos += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)pos);
+        __m128i is_ctrl = _mm_cmpeq_epi8(_mm_min_epu8(block, ctrl_max), block);
+        __m128i is_special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, slash)), is_ctrl);
+        unsigned mask = (unsigned)_mm_movemask_epi8(is_special);
+        if (mask != 0) {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    return scan_string_scalar(pos, end);
+}
+
+static const scan_impl_t scan_sse2 = {
+    .name = "sse2",
+    .spaces = scan_spaces_sse2,
+    .string = scan_string_sse2,
+};
+
+__attribute__((target("avx2"))) static const char* scan_spaces_avx2(const char* pos, const char* end)
+{
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i ctrl_low = _mm256_set1_epi8('\t' - 1);
+    const __m256i ctrl_high = _mm256_set1_epi8('\r' + 1);
+    for (; end - pos >= 32; pos += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)pos);
+        __m256i is_ctrl = _mm256_and_si256(_mm256_cmpgt_epi8(block, ctrl_low), _mm256_cmpgt_epi8(ctrl_high, block));
+        __m256i is_space = _mm256_or_si256(_mm256_cmpeq_epi8(block, space), is_ctrl);
+        unsigned mask = ~(unsigned)_mm256_movemask_epi8(is_space);
+        if (mask != 0) {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    return scan_spaces_sse2(pos, end);
+}
+
+__attribute__((target("avx2"))) static const char* scan_string_avx2(const char* pos, const char* end)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i slash = _mm256_set1_epi8('\\');
+    const __m256i ctrl_max = _mm256_set1_epi8(0x1F);
+    for (; end - pos >= 32; pos += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)pos);
+        __m256i is_ctrl = _mm256_cmpeq_epi8(_mm256_min_epu8(block, ctrl_max), block);
+        __m256i is_special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, quote), _mm256_cmpeq_epi8(block, slash)), is_ctrl);
+        unsigned mask = (unsigned)_mm256_movemask_epi8(is_special);
+        if (mask != 0) {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    return scan_string_sse2(pos, end);
+}
+
+static const scan_impl_t scan_avx2 = {
+    .name = "avx2",
+    .spaces = scan_spaces_avx2,
+    .string = scan_string_avx2,
+};
+
+#endif
+
+static const scan_impl_t* scan_supported[4];
+static const scan_impl_t* scan_selected = &scan_scalar;
+
+__attribute__((constructor)) static void scan_select(void)
+{
+    size_t count = 0;
+#ifdef SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        scan_supported[count++] = &scan_avx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        scan_supported[count++] = &scan_sse2;
+    }
+#endif
+    scan_supported[count++] = &scan_scalar;
+    scan_selected = scan_supported[0];
+    log_debug_msg("scan implementation: %s", scan_selected->name);
+}
+
+const scan_impl_t* scan_impl(void)
+{
+    return scan_selected;
+}
+
+const scan_impl_t* const* scan_impl_list(void)
+{
+    return scan_supported;
+}
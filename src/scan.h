@@ -0,0 +1,47 @@
+/// Copyright © Alexander Kaluzhnyy
+
+#ifndef SCAN_H_INCLUDED
+#define SCAN_H_INCLUDED
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct scan_impl_t {
+    const char* name;
+    ///
+    ///@brief Find first symbol that is not space
+    ///@return pointer to found symbol or end
+    ///
+    const char* (*spaces)(const char* pos, const char* end);
+    ///
+    ///@brief Find first symbol that ends plain run of string: '"', '\\' or control symbol
+    ///@return pointer to found symbol or end
+    ///
+    const char* (*string)(const char* pos, const char* end);
+} scan_impl_t;
+
+extern const unsigned char scan_space_table[256];
+
+#define scan_isspace(c) (scan_space_table[(unsigned char)(c)])
+
+///
+///@brief Implementation selected for current CPU
+///
+const scan_impl_t* scan_impl(void);
+
+///
+///@brief All implementations supported by current CPU. Last element is NULL
+///
+const scan_impl_t* const* scan_impl_list(void);
+
+#define scan_spaces(pos, end) (scan_impl()->spaces(pos, end))
+#define scan_string(pos, end) (scan_impl()->string(pos, end))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SCAN_H_INCLUDED
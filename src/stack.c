@@ -0,0 +1,50 @@
+/// Copyright © Alexander Kaluzhnyy
+
+#include "stack.h"
+#include "log.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STACK_MIN_CAPACITY 256
+
+void* json_stack_push(json_stack_t* self, size_t elem_size)
+{
+    if (self->capacity - self->size < elem_size) {
+        size_t capacity = self->capacity ? self->capacity * 2 : STACK_MIN_CAPACITY;
+        while (capacity - self->size < elem_size) {
+            capacity *= 2;
+        }
+        char* data = realloc(self->data, capacity);
+        if (data == NULL) {
+            log_error_msg("realloc(): %s(%i)", strerror(errno), errno);
+            return NULL;
+        }
+        log_debug_msg("increase stack to %zu", capacity);
+        self->data = data;
+        self->capacity = capacity;
+    }
+    self->size += elem_size;
+    return &self->data[self->size - elem_size];
+}
+
+void* json_stack_top(json_stack_t* self, size_t elem_size)
+{
+    if (self->size < elem_size) {
+        return NULL;
+    }
+    return &self->data[self->size - elem_size];
+}
+
+void json_stack_pop(json_stack_t* self, size_t elem_size)
+{
+    if (self->size >= elem_size) {
+        self->size -= elem_size;
+    }
+}
+
+void json_stack_cleanup(json_stack_t* self)
+{
+    free(self->data);
+    memset(self, 0, sizeof(*self));
+}
@@ -0,0 +1,43 @@
+/// Copyright © Alexander Kaluzhnyy
+
+#ifndef STACK_H_INCLUDED
+#define STACK_H_INCLUDED
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+///
+///@brief Heap allocated stack of same sized elements
+/// \n Zero filled value is empty stack
+///
+typedef struct json_stack_t {
+    char* data;
+    size_t size;
+    size_t capacity;
+} json_stack_t;
+
+///
+///@brief Add element on top of stack
+///@return pointer to new element. NULL in case of allocation error
+///
+void* json_stack_push(json_stack_t* self, size_t elem_size);
+///
+///@return pointer to top element. NULL if stack is empty
+///
+void* json_stack_top(json_stack_t* self, size_t elem_size);
+void json_stack_pop(json_stack_t* self, size_t elem_size);
+void json_stack_cleanup(json_stack_t* self);
+
+#define STACK_PUSH(stack, type) ((type*)json_stack_push(stack, sizeof(type)))
+#define STACK_TOP(stack, type) ((type*)json_stack_top(stack, sizeof(type)))
+#define STACK_POP(stack, type) json_stack_pop(stack, sizeof(type))
+#define STACK_SIZE(stack, type) ((stack)->size / sizeof(type))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STACK_H_INCLUDED
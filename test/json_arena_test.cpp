@@ -0,0 +1,182 @@
+/// Copyright © Alexander Kaluzhnyy
+#include <gtest/gtest.h>
+#include "json.h"
+#include "json_arena.h"
+#include "json_parser.h"
+#include "json_printer.h"
+#include "log.h"
+#include "system_mock.hpp"
+#include <string>
+
+namespace json_test {
+
+using namespace ::testing;
+
+class json_arena_tests : public Test {
+protected:
+    json_arena_t* m_arena = nullptr;
+    json_parser_t* m_parser = nullptr;
+    void SetUp() override
+    {
+        m_arena = json_arena_init();
+        ASSERT_NE(nullptr, m_arena);
+        m_parser = json_parser_init();
+        ASSERT_NE(nullptr, m_parser);
+        json_parser_set_arena(m_parser, m_arena);
+    }
+    void TearDown() override
+    {
+        json_parser_deinit(&m_parser);
+        json_arena_deinit(&m_arena);
+        EXPECT_EQ(nullptr, m_arena);
+    }
+    json_t* parse(const std::string& str)
+    {
+        json_t* value = json_parser_parse_buf(m_parser, str.data(), str.size(), nullptr);
+        EXPECT_NE(nullptr, value);
+        return value;
+    }
+    static std::string print(json_t** value)
+    {
+        char* out = json_sprint(value, 0);
+        std::string str = out != nullptr ? out : "NULL";
+        free(out);
+        return str;
+    }
+};
+
+static const char JSON_ARENA_DOCUMENT[] = R"JSON({"a":[1,"s",null,true,{"b":-2.5e3}],"a2":{},"c":"str"})JSON";
+
+TEST_F(json_arena_tests, parse_positive)
+{
+    log_trace_func();
+    json_t* value = parse(JSON_ARENA_DOCUMENT);
+    EXPECT_EQ(JSON_ARENA_DOCUMENT, print(&value));
+    json_t* alias = value;
+    json_deinit(&value);
+    EXPECT_EQ(JSON_ARENA_DOCUMENT, print(&alias));
+}
+
+TEST_F(json_arena_tests, parse_no_heap_allocations_positive)
+{
+    log_trace_func();
+    parse(JSON_ARENA_DOCUMENT);
+    NiceMock<system_mock> mock;
+    EXPECT_CALL(mock, malloc(_)).Times(0);
+    EXPECT_CALL(mock, calloc(_, _)).Times(0);
+    EXPECT_CALL(mock, realloc(_, _)).Times(0);
+    EXPECT_CALL(mock, free(_)).Times(0);
+    for (size_t i = 0; i < 100; i++) {
+        json_t* value = parse(JSON_ARENA_DOCUMENT);
+        json_deinit(&value);
+    }
+}
+
+TEST_F(json_arena_tests, big_values_positive)
+{
+    log_trace_func();
+    std::string str = "[";
+    for (size_t i = 0; i < 10000; i++) {
+        str += std::to_string(i) + ",";
+    }
+    str.back() = ']';
+    json_t* value = parse(str);
+    EXPECT_EQ(str, print(&value));
+    str = "{";
+    for (size_t i = 0; i < 1000; i++) {
+        str += "\"k" + std::to_string(i) + "\":" + std::to_string(i) + ",";
+    }
+    str.back() = '}';
+    value = parse(str);
+    EXPECT_STREQ("999", json_get_str(json_get_by_key(&value, "k999")));
+}
+
+TEST_F(json_arena_tests, build_positive)
+{
+    log_trace_func();
+    json_t* object = json_arena_init_from_value(m_arena, "object", nullptr);
+    ASSERT_NE(nullptr, object);
+    std::string expected = "{";
+    for (size_t i = 0; i < 100; i++) {
+        const std::string key = "k" + std::to_string(i);
+        json_t* value = json_arena_init_from_value(m_arena, "number", std::to_string(i).c_str());
+        ASSERT_NE(nullptr, json_set_by_key(&object, &value, key.c_str()));
+        EXPECT_EQ(value, *json_get_by_key(&object, key.c_str()));
+        expected += "\"" + key + "\":" + std::to_string(i) + ",";
+    }
+    expected.back() = '}';
+    EXPECT_EQ(expected, print(&object));
+    json_t* array = json_arena_init_from_value(m_arena, "array", nullptr);
+    ASSERT_NE(nullptr, array);
+    ASSERT_NE(nullptr, json_set_by_id(&array, &object, 0));
+    EXPECT_EQ("[" + expected + "]", print(&array));
+}
+
+TEST_F(json_arena_tests, heap_value_moved_into_arena_positive)
+{
+    log_trace_func();
+    json_t* object = parse("{}");
+    json_t* value = json_init_from_str(R"JSON([1,{"k":"v"}])JSON", nullptr);
+    ASSERT_NE(nullptr, value);
+    ASSERT_NE(nullptr, json_set_by_key(&object, &value, "key"));
+    // heap value released, elem points to its copy in arena
+    EXPECT_EQ(value, *json_get_by_key(&object, "key"));
+    EXPECT_EQ(R"JSON({"key":[1,{"k":"v"}]})JSON", print(&object));
+    json_t* str = json_init_from_value("string", "replaced");
+    ASSERT_NE(nullptr, json_set(json_get_by_id(&value, 1), &str));
+    EXPECT_EQ(R"JSON({"key":[1,"replaced"]})JSON", print(&object));
+}
+
+TEST_F(json_arena_tests, arena_value_copied_to_heap_positive)
+{
+    log_trace_func();
+    json_t* value = parse(JSON_ARENA_DOCUMENT);
+    json_t* heap = json_init_from_str("[]", nullptr);
+    ASSERT_NE(nullptr, heap);
+    ASSERT_NE(nullptr, json_set_by_id(&heap, &value, 0));
+    json_t* copy = json_copy(&value);
+    ASSERT_NE(nullptr, copy);
+    json_arena_deinit(&m_arena);
+    json_parser_set_arena(m_parser, nullptr);
+    EXPECT_EQ(std::string("[") + JSON_ARENA_DOCUMENT + "]", print(&heap));
+    EXPECT_EQ(JSON_ARENA_DOCUMENT, print(&copy));
+    json_deinit(&heap);
+    json_deinit(&copy);
+}
+
+TEST_F(json_arena_tests, other_arena_value_copied_positive)
+{
+    log_trace_func();
+    json_arena_t* other = json_arena_init();
+    ASSERT_NE(nullptr, other);
+    json_t* value = json_arena_init_from_value(other, "string", "other");
+    ASSERT_NE(nullptr, value);
+    json_t* array = parse("[1]");
+    ASSERT_NE(nullptr, json_set_by_id(&array, &value, 1));
+    json_arena_deinit(&other);
+    EXPECT_EQ(R"JSON([1,"other"])JSON", print(&array));
+}
+
+TEST_F(json_arena_tests, keep_keys_positive)
+{
+    log_trace_func();
+    json_parser_set_arena(m_parser, nullptr);
+    json_parser_set_keep_keys(m_parser, 1);
+    json_t* heap = json_parser_parse_buf(m_parser, "{\"k\":1}", 7, nullptr);
+    ASSERT_NE(nullptr, heap);
+    json_parser_set_arena(m_parser, m_arena);
+    json_t* value = parse("{\"k\":2}");
+    EXPECT_NE(json_key(&heap, 0), json_key(&value, 0));
+    json_deinit(&heap);
+    EXPECT_EQ("{\"k\":2}", print(&value));
+}
+
+TEST(json_arena, nullptr_negative)
+{
+    log_trace_func();
+    EXPECT_EQ(nullptr, json_arena_init_from_value(nullptr, "null", nullptr));
+    json_arena_deinit(nullptr);
+    json_arena_t* arena = nullptr;
+    json_arena_deinit(&arena);
+}
+}
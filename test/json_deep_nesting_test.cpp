@@ -0,0 +1,123 @@
+/// Copyright © Alexander Kaluzhnyy
+#include <gtest/gtest.h>
+#include "json.h"
+#include "json_parser.h"
+#include "json_printer.h"
+#include "log.h"
+#include <string>
+
+namespace json_test {
+
+using namespace ::testing;
+
+static const size_t DEEP_NESTING = 2000;
+
+static std::string make_nested(size_t depth, const char* open, const char* value, const char* close)
+{
+    std::string ret;
+    for (size_t i = 0; i < depth; i++) {
+        ret += open;
+    }
+    ret += value;
+    for (size_t i = 0; i < depth; i++) {
+        ret += close;
+    }
+    return ret;
+}
+
+class json_deep_nesting_tests : public Test {
+protected:
+    json_t* m_object = nullptr;
+    json_t* m_copy = nullptr;
+    char* m_out = nullptr;
+    void TearDown() override
+    {
+        free(m_out);
+        json_deinit(&m_copy);
+        json_deinit(&m_object);
+    }
+};
+
+TEST_F(json_deep_nesting_tests, deep_array_positive)
+{
+    const std::string str = make_nested(DEEP_NESTING, "[", "null", "]");
+    m_object = json_init_from_buf(str.data(), str.size(), nullptr);
+    ASSERT_NE(nullptr, m_object);
+    m_copy = json_copy(&m_object);
+    ASSERT_NE(nullptr, m_copy);
+    m_out = json_sprint(&m_copy, 0);
+    ASSERT_NE(nullptr, m_out);
+    EXPECT_EQ(str, m_out);
+}
+
+TEST_F(json_deep_nesting_tests, deep_object_positive)
+{
+    const std::string str = make_nested(DEEP_NESTING, "{\"k\":[", "1", "]}");
+    m_object = json_init_from_buf(str.data(), str.size(), nullptr);
+    ASSERT_NE(nullptr, m_object);
+    m_out = json_sprint(&m_object, 0);
+    ASSERT_NE(nullptr, m_out);
+    EXPECT_EQ(str, m_out);
+}
+
+TEST_F(json_deep_nesting_tests, deep_self_insert_positive)
+{
+    const std::string str = make_nested(DEEP_NESTING, "[", "", "]");
+    m_object = json_init_from_buf(str.data(), str.size(), nullptr);
+    ASSERT_NE(nullptr, m_object);
+    ASSERT_NE(nullptr, json_set_by_id(&m_object, &m_object, 1));
+    EXPECT_EQ(2u, json_size(&m_object));
+}
+
+TEST_F(json_deep_nesting_tests, deep_unfinished_negative)
+{
+    const std::string str = make_nested(DEEP_NESTING, "[", "{\"k\":", "");
+    size_t consumed = 0;
+    EXPECT_EQ(nullptr, json_init_from_buf(str.data(), str.size(), &consumed));
+    EXPECT_EQ(str.size(), consumed);
+}
+
+class json_max_depth_tests : public json_deep_nesting_tests {
+protected:
+    json_parser_t* m_parser = nullptr;
+    void SetUp() override
+    {
+        m_parser = json_parser_init();
+        ASSERT_NE(nullptr, m_parser);
+        json_parser_set_max_depth(m_parser, 3);
+    }
+    void TearDown() override
+    {
+        json_parser_deinit(&m_parser);
+        json_deep_nesting_tests::TearDown();
+    }
+};
+
+TEST_F(json_max_depth_tests, on_limit_positive)
+{
+    log_trace_func();
+    const char str[] = R"JSON([{"k":[1]},[[]]])JSON";
+    m_object = json_parser_parse_buf(m_parser, str, sizeof(str) - 1, nullptr);
+    ASSERT_NE(nullptr, m_object);
+    m_out = json_sprint(&m_object, 0);
+    EXPECT_STREQ(str, m_out);
+}
+
+TEST_F(json_max_depth_tests, over_limit_negative)
+{
+    log_trace_func();
+    const char str[] = R"JSON([{"k":[1]},[[[]]]])JSON";
+    size_t consumed = 0;
+    EXPECT_EQ(nullptr, json_parser_parse_buf(m_parser, str, sizeof(str) - 1, &consumed));
+    EXPECT_EQ(13u, consumed);
+}
+
+TEST_F(json_max_depth_tests, unlimited_positive)
+{
+    log_trace_func();
+    json_parser_set_max_depth(m_parser, 0);
+    const std::string str = make_nested(100, "[", "", "]");
+    m_object = json_parser_parse_buf(m_parser, str.data(), str.size(), nullptr);
+    ASSERT_NE(nullptr, m_object);
+}
+}
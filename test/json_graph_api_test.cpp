@@ -3,6 +3,7 @@
 #include "json.h"
 #include "json_printer.h"
 #include "log.h"
+#include "system_mock.hpp"
 #include <stdio.h>
 
 namespace json_test {
@@ -237,4 +238,161 @@ TEST_F(json_base, json_set_positive)
     JSON_STREQ(&m_object, m_child_str.c_str());
 }
 
+TEST_F(json_base, big_object_by_key_positive)
+{
+    log_trace_func();
+    const size_t count = 1000;
+    m_object = json_init_from_str("{}", nullptr);
+    ASSERT_NE(nullptr, m_object);
+    for (size_t i = 0; i < count; i++) {
+        json_t* value = json_init_from_value("number", std::to_string(i).c_str());
+        ASSERT_NE(nullptr, json_set_by_key(&m_object, &value, ("k" + std::to_string(i)).c_str()));
+    }
+    json_t* value = json_init_from_value("string", "replaced");
+    ASSERT_NE(nullptr, json_set_by_key(&m_object, &value, "k500"));
+    json_t* copy = json_copy(&m_object);
+    ASSERT_NE(nullptr, copy);
+    for (json_t** object : { &m_object, &copy }) {
+        ASSERT_EQ(count, json_size(object));
+        for (size_t i = 0; i < count; i++) {
+            const std::string key = "k" + std::to_string(i);
+            EXPECT_STREQ(key.c_str(), json_key(object, i));
+            json_t** node = json_get_by_key(object, key.c_str());
+            ASSERT_EQ(json_get_by_id(object, i), node);
+            EXPECT_STREQ(i == 500 ? "replaced" : std::to_string(i).c_str(), json_get_str(node));
+        }
+        EXPECT_EQ(nullptr, json_get_by_key(object, "k1000"));
+    }
+    json_deinit(&copy);
+}
+
+TEST_F(json_base, big_object_duplicated_key_positive)
+{
+    log_trace_func();
+    std::string str = "{";
+    for (size_t i = 0; i < 100; i++) {
+        str += "\"k" + std::to_string(i % 50) + "\":" + std::to_string(i) + ",";
+    }
+    str.back() = '}';
+    m_object = json_init_from_str(str.c_str(), nullptr);
+    ASSERT_NE(nullptr, m_object);
+    EXPECT_STREQ("7", json_get_str(json_get_by_key(&m_object, "k7")));
+}
+
+static void append_numbers(json_t** array, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        json_t* value = json_init_from_value("number", std::to_string(i).c_str());
+        ASSERT_NE(nullptr, json_set_by_id(array, &value, json_size(array)));
+    }
+}
+
+TEST_F(json_base, append_grows_geometrically_positive)
+{
+    log_trace_func();
+    m_object = json_init_from_str("[]", nullptr);
+    ASSERT_NE(nullptr, m_object);
+    NiceMock<system_mock> mock;
+    size_t count = 0;
+    EXPECT_CALL(mock, realloc(_, _)).WillRepeatedly([&count](void* ptr, size_t size) {
+        count += ptr != nullptr;
+        return real(realloc)(ptr, size);
+    });
+    append_numbers(&m_object, 1000);
+    EXPECT_EQ(1000u, json_size(&m_object));
+    EXPECT_GE(10u, count);
+}
+
+TEST_F(json_base, reserve_positive)
+{
+    log_trace_func();
+    m_object = json_init_from_str("[1,2]", nullptr);
+    ASSERT_NE(nullptr, m_object);
+    ASSERT_EQ(&m_object, json_reserve(&m_object, 100));
+    {
+        NiceMock<system_mock> mock;
+        EXPECT_CALL(mock, realloc(IsNull(), _)).Times(AnyNumber());
+        EXPECT_CALL(mock, realloc(NotNull(), _)).Times(0);
+        append_numbers(&m_object, 98);
+    }
+    EXPECT_EQ(100u, json_size(&m_object));
+    EXPECT_STREQ("1", json_get_str(json_get_by_id(&m_object, 0)));
+    EXPECT_STREQ("97", json_get_str(json_get_by_id(&m_object, 99)));
+    // smaller capacity does not change container
+    EXPECT_EQ(&m_object, json_reserve(&m_object, 1));
+    EXPECT_EQ(100u, json_size(&m_object));
+}
+
+TEST_F(json_base, reserve_object_positive)
+{
+    log_trace_func();
+    m_object = json_init_from_str("{}", nullptr);
+    ASSERT_NE(nullptr, m_object);
+    ASSERT_EQ(&m_object, json_reserve(&m_object, 10));
+    NiceMock<system_mock> mock;
+    EXPECT_CALL(mock, realloc(IsNull(), _)).Times(AnyNumber());
+    EXPECT_CALL(mock, realloc(NotNull(), _)).Times(0);
+    for (size_t i = 0; i < 10; i++) {
+        json_t* value = json_init_from_value("number", std::to_string(i).c_str());
+        ASSERT_NE(nullptr, json_set_by_key(&m_object, &value, ("k" + std::to_string(i)).c_str()));
+    }
+    EXPECT_EQ(10u, json_size(&m_object));
+}
+
+TEST_F(json_base, reserve_shared_positive)
+{
+    log_trace_func();
+    m_object = json_init_from_str("[1]", nullptr);
+    ASSERT_NE(nullptr, m_object);
+    json_t* copy = json_copy(&m_object);
+    ASSERT_NE(nullptr, copy);
+    ASSERT_EQ(&copy, json_reserve(&copy, 10));
+    append_numbers(&copy, 1);
+    JSON_STREQ(&m_object, "[1]");
+    JSON_STREQ(&copy, "[1,0]");
+    json_deinit(&copy);
+}
+
+TEST_F(json_base, shrink_to_fit_positive)
+{
+    log_trace_func();
+    m_object = json_init_from_str("[]", nullptr);
+    ASSERT_NE(nullptr, m_object);
+    append_numbers(&m_object, 5);
+    {
+        NiceMock<system_mock> mock;
+        EXPECT_CALL(mock, realloc(_, _)).Times(1);
+        ASSERT_EQ(&m_object, json_shrink_to_fit(&m_object));
+    }
+    {
+        NiceMock<system_mock> mock;
+        EXPECT_CALL(mock, realloc(_, _)).Times(0);
+        ASSERT_EQ(&m_object, json_shrink_to_fit(&m_object));
+    }
+    JSON_STREQ(&m_object, "[0,1,2,3,4]");
+    append_numbers(&m_object, 1);
+    JSON_STREQ(&m_object, "[0,1,2,3,4,0]");
+}
+
+TEST_F(json_base, reserve_negative)
+{
+    log_trace_func();
+    m_object = json_init_from_str("\"str\"", nullptr);
+    ASSERT_NE(nullptr, m_object);
+    EXPECT_EQ(nullptr, json_reserve(&m_object, 10));
+    EXPECT_EQ(nullptr, json_shrink_to_fit(&m_object));
+    json_t* object = json_init_from_str("{}", nullptr);
+    ASSERT_NE(nullptr, object);
+    EXPECT_EQ(nullptr, json_reserve(&object, SIZE_MAX / 2 + 1));
+    json_deinit(&object);
+    m_child = json_init_from_str("[1]", nullptr);
+    ASSERT_NE(nullptr, m_child);
+    {
+        NiceMock<system_mock> mock;
+        EXPECT_CALL(mock, realloc(_, _)).WillOnce(Return(nullptr));
+        EXPECT_EQ(nullptr, json_reserve(&m_child, 100));
+    }
+    JSON_STREQ(&m_child, "[1]");
+}
+
 }
\ No newline at end of file
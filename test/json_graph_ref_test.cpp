@@ -4,7 +4,10 @@
 #include "json.h"
 #include "json_printer.h"
 #include "log.h"
+#include "system_mock.hpp"
 #include <stdio.h>
+#include <thread>
+#include <vector>
 
 namespace json_test {
 
@@ -32,6 +35,23 @@ TEST_F(json_graph_ref_test, deinit_no_effect_for_objects_have_root_positive)
     ASSERT_JSONSTREQ(&obj, "[[123]]");
     json_deinit(&obj);
 }
+TEST_F(json_graph_ref_test, copy_of_stored_literal_has_no_root_positive)
+{
+    log_trace_func();
+    json_t* obj = json_init_from_str("[null,true,false]", nullptr);
+    ASSERT_NE(nullptr, obj);
+    for (size_t id = 0; id < json_size(&obj); id++) {
+        json_t** child = json_get_by_id(&obj, id);
+        json_t* copy = json_copy(child);
+        ASSERT_NE(nullptr, copy);
+        json_deinit(&copy);
+        EXPECT_EQ(nullptr, copy);
+        json_deinit(child);
+        EXPECT_NE(nullptr, *child);
+    }
+    ASSERT_JSONSTREQ(&obj, "[null,true,false]");
+    json_deinit(&obj);
+}
 TEST_F(json_graph_ref_test, create_simple_circular_to_empty_array_positive)
 {
     log_trace_func();
@@ -193,4 +213,160 @@ mega_ref_test(set_node_3_to_node, set(&node, &node, 3), "[1," NODE2 "," NODE3 ",
 
 // mega_ref_test(set_Node_1_1_to_node, set(get(node, 1), node, 1), "[1,[2," NODE1 "," NODE5 "]," NODE3 "," NODE5 "]");
 // mega_ref_test(set_Node_1_2_to_node, set(get(node, 1), node, 2), "[1,[2," NODE4 "," NODE1 "]," NODE3 "," NODE5 "]");
-}
\ No newline at end of file
+
+static const char JSON_SHARED_DOCUMENT[] = R"JSON({"k":["s1",2,"s3",{"n":-4.5}]})JSON";
+
+TEST_F(json_graph_ref_test, copies_outlive_value_positive)
+{
+    log_trace_func();
+    json_t* value = json_init_from_str(JSON_SHARED_DOCUMENT, nullptr);
+    ASSERT_NE(nullptr, value);
+    std::vector<json_t*> copies;
+    for (size_t i = 0; i < 8; i++) {
+        copies.push_back(json_copy(&value));
+        ASSERT_NE(nullptr, copies.back());
+    }
+    json_deinit(&value);
+    for (auto& copy : copies) {
+        ASSERT_JSONSTREQ(&copy, JSON_SHARED_DOCUMENT);
+        json_deinit(&copy);
+    }
+}
+
+static const char JSON_COW_DOCUMENT[] = R"JSON({"a":{"b":[1,2]},"c":{"d":"e"}})JSON";
+
+TEST_F(json_graph_ref_test, copy_on_write_positive)
+{
+    log_trace_func();
+    json_t* value = json_init_from_str(JSON_COW_DOCUMENT, nullptr);
+    ASSERT_NE(nullptr, value);
+    json_t* copy = json_copy_shared(&value);
+    ASSERT_NE(nullptr, copy);
+    EXPECT_NE(value, copy);
+    EXPECT_EQ(*json_get_by_key(&value, "a"), *json_get_by_key(&copy, "a"));
+    json_t* elem = json_init_from_str("3", nullptr);
+    ASSERT_NE(nullptr, json_set_by_id(json_get_mut_by_key(json_get_mut_by_key(&copy, "a"), "b"), &elem, 2));
+    ASSERT_JSONSTREQ(&value, JSON_COW_DOCUMENT);
+    ASSERT_JSONSTREQ(&copy, R"JSON({"a":{"b":[1,2,3]},"c":{"d":"e"}})JSON");
+    // only containers on path to changed value are copied
+    EXPECT_NE(*json_get_by_key(&value, "a"), *json_get_by_key(&copy, "a"));
+    EXPECT_EQ(*json_get_by_key(&value, "c"), *json_get_by_key(&copy, "c"));
+    json_deinit(&value);
+    ASSERT_JSONSTREQ(&copy, R"JSON({"a":{"b":[1,2,3]},"c":{"d":"e"}})JSON");
+    json_deinit(&copy);
+}
+
+TEST_F(json_graph_ref_test, get_then_set_nested_copy_positive)
+{
+    log_trace_func();
+    json_t* orig = json_init_from_str(R"JSON({"a":{"b":1}})JSON", nullptr);
+    ASSERT_NE(nullptr, orig);
+    json_t* copy = json_copy(&orig);
+    ASSERT_NE(nullptr, copy);
+    json_t* elem = json_init_from_str("2", nullptr);
+    ASSERT_NE(nullptr, json_set_by_key(json_get_by_key(&copy, "a"), &elem, "b"));
+    ASSERT_JSONSTREQ(&orig, R"JSON({"a":{"b":1}})JSON");
+    ASSERT_JSONSTREQ(&copy, R"JSON({"a":{"b":2}})JSON");
+    json_deinit(&copy);
+    json_deinit(&orig);
+}
+
+TEST_F(json_graph_ref_test, read_shared_without_copy_positive)
+{
+    log_trace_func();
+    json_t* value = json_init_from_str(JSON_COW_DOCUMENT, nullptr);
+    ASSERT_NE(nullptr, value);
+    json_t* copy = json_copy_shared(&value);
+    ASSERT_NE(nullptr, copy);
+    char buf[sizeof(JSON_COW_DOCUMENT)];
+    FILE* file = fmemopen(buf, sizeof(buf), "w");
+    ASSERT_NE(nullptr, file);
+    {
+        NiceMock<system_mock> mock;
+        EXPECT_CALL(mock, malloc(_)).Times(0);
+        EXPECT_CALL(mock, calloc(_, _)).Times(0);
+        EXPECT_CALL(mock, realloc(_, _)).Times(0);
+        json_t** b = json_get_by_key(json_get_by_key(&copy, "a"), "b");
+        ASSERT_NE(nullptr, b);
+        EXPECT_EQ(*json_get_by_key(json_get_by_key(&value, "a"), "b"), *b);
+        EXPECT_STREQ("2", json_get_str(json_get_by_id(b, 1)));
+        EXPECT_EQ(nullptr, json_get_by_key(&copy, "x"));
+        EXPECT_EQ(nullptr, json_get_by_id(b, 2));
+    }
+    {
+        NiceMock<system_mock> mock;
+        EXPECT_CALL(mock, malloc(_)).Times(0);
+        // nodes are not copied, only stack of printer is allocated
+        EXPECT_CALL(mock, calloc(_, _)).Times(0);
+        EXPECT_EQ((ssize_t)strlen(JSON_COW_DOCUMENT), json_fprint(&copy, 0, file));
+    }
+    fclose(file);
+    EXPECT_STREQ(JSON_COW_DOCUMENT, buf);
+    EXPECT_EQ(*json_get_by_key(&value, "a"), *json_get_by_key(&copy, "a"));
+    json_deinit(&copy);
+    json_deinit(&value);
+}
+
+TEST_F(json_graph_ref_test, set_elem_sharing_children_with_copy_positive)
+{
+    log_trace_func();
+    json_t* value = json_init_from_str("{}", nullptr);
+    json_t* elem = json_init_from_str("[[1]]", nullptr);
+    json_t* copy = json_copy_shared(&elem);
+    ASSERT_NE(nullptr, json_set_by_key(&value, &elem, "k"));
+    EXPECT_EQ(elem, *json_get_by_key(&value, "k"));
+    json_t* two = json_init_from_str("2", nullptr);
+    ASSERT_NE(nullptr, json_set_by_id(json_get_mut_by_id(&copy, 0), &two, 1));
+    ASSERT_JSONSTREQ(&value, R"JSON({"k":[[1]]})JSON");
+    ASSERT_JSONSTREQ(&copy, "[[1,2]]");
+    json_deinit(&copy);
+    json_deinit(&value);
+}
+
+TEST_F(json_graph_ref_test, copy_on_write_negative)
+{
+    log_trace_func();
+    json_t* value = json_init_from_str(JSON_COW_DOCUMENT, nullptr);
+    ASSERT_NE(nullptr, value);
+    json_t* copy = json_copy_shared(&value);
+    ASSERT_NE(nullptr, copy);
+    json_t* shared = *json_get_by_key(&copy, "a");
+    {
+        NiceMock<system_mock> mock;
+        EXPECT_CALL(mock, calloc(_, _)).WillOnce(Return(nullptr));
+        EXPECT_EQ(nullptr, json_get_mut_by_key(json_get_mut_by_key(&copy, "a"), "b"));
+    }
+    EXPECT_EQ(shared, *json_get_by_key(&copy, "a"));
+    json_deinit(&copy);
+    ASSERT_JSONSTREQ(&value, JSON_COW_DOCUMENT);
+    json_deinit(&value);
+}
+
+#ifdef JSON_ATOMIC_REFCNT
+TEST_F(json_graph_ref_test, copies_released_by_threads_positive)
+{
+    log_trace_func();
+    json_t* value = json_init_from_str(JSON_SHARED_DOCUMENT, nullptr);
+    ASSERT_NE(nullptr, value);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 8; i++) {
+        json_t* copy = json_copy_shared(&value);
+        ASSERT_NE(nullptr, copy);
+        threads.emplace_back([copy]() mutable {
+            for (size_t j = 0; j < 1000; j++) {
+                json_t* nested = json_copy_shared(&copy);
+                json_deinit(&nested);
+            }
+            // shared containers are copied on change by each thread
+            json_t* elem = json_init_from_str("1", nullptr);
+            json_set_by_id(json_get_mut_by_key(&copy, "k"), &elem, 0);
+            json_deinit(&copy);
+        });
+    }
+    json_deinit(&value);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+#endif
+}
@@ -0,0 +1,149 @@
+/// Copyright © Alexander Kaluzhnyy
+#include <gtest/gtest.h>
+#include "json.h"
+#include "json_printer.h"
+#include "log.h"
+#include <string>
+
+namespace json_test {
+
+using namespace ::testing;
+
+class json_init_from_buf_tests : public Test {
+protected:
+    json_t* m_object = nullptr;
+    char* m_out = nullptr;
+    size_t m_consumed = 0;
+    void TearDown() override
+    {
+        free(m_out);
+        json_deinit(&m_object);
+    }
+};
+
+#define json_init_from_buf_positive_test(name, buf, len, expected, expected_consumed) \
+    TEST_F(json_init_from_buf_tests, name##_positive)                               \
+    {                                                                               \
+        log_trace_func();                                                           \
+        m_object = json_init_from_buf(buf, len, &m_consumed);                       \
+        ASSERT_NE(nullptr, m_object);                                               \
+        m_out = json_sprint(&m_object, 0);                                          \
+        EXPECT_STREQ(expected, m_out);                                              \
+        EXPECT_EQ((size_t)expected_consumed, m_consumed);                           \
+    }
+
+#define json_init_from_buf_negative_test(name, buf, len, expected_consumed) \
+    TEST_F(json_init_from_buf_tests, name##_negative)                     \
+    {                                                                     \
+        log_trace_func();                                                 \
+        m_object = json_init_from_buf(buf, len, &m_consumed);             \
+        EXPECT_EQ(nullptr, m_object);                                     \
+        EXPECT_EQ((size_t)expected_consumed, m_consumed);                 \
+    }
+
+json_init_from_buf_positive_test(number_whole_buffer, "123", 3, "123", 3);
+json_init_from_buf_positive_test(number_part_of_buffer, "123456", 3, "123", 3);
+json_init_from_buf_positive_test(number_with_tail, "123,456", 7, "123", 3);
+json_init_from_buf_positive_test(string_part_of_buffer, "\"abc\"def\"", 5, "\"abc\"", 5);
+json_init_from_buf_positive_test(null_part_of_buffer, "nullnull", 4, "null", 4);
+json_init_from_buf_positive_test(array_with_tail, "[1,\"2\",{}] [3]", 14, "[1,\"2\",{}]", 10);
+json_init_from_buf_positive_test(object_with_spaces, "  { \"key\" : [ true ] }  ", 24, "{\"key\":[true]}", 22);
+
+static const char JSON_LONG_INDENT[] = "\n                                                \t\t\t\t[\r\n                                        1\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n,\n                                        2]                                        ";
+json_init_from_buf_positive_test(long_indent, JSON_LONG_INDENT, sizeof(JSON_LONG_INDENT) - 1, "[1,2]", sizeof(JSON_LONG_INDENT) - 41);
+
+json_init_from_buf_negative_test(empty_buffer, "null", 0, 0);
+json_init_from_buf_negative_test(cut_literal, "null", 3, 3);
+json_init_from_buf_negative_test(cut_string, "\"abc\"", 4, 4);
+json_init_from_buf_negative_test(cut_array, "[1,2]", 4, 4);
+json_init_from_buf_negative_test(cut_number_fraction, "1.5", 2, 2);
+json_init_from_buf_negative_test(zero_inside_string, "\"a\0b\"", 5, 2);
+json_init_from_buf_negative_test(spaced_unexpected_symbol, "[1    x]", 8, 6);
+json_init_from_buf_negative_test(spaced_bad_number, "[    12x]", 9, 7);
+json_init_from_buf_negative_test(spaced_quote_after_number, "[1    \"a\"]", 10, 6);
+
+TEST_F(json_init_from_buf_tests, consumed_nullptr_positive)
+{
+    log_trace_func();
+    m_object = json_init_from_buf("[null]", 6, nullptr);
+    ASSERT_NE(nullptr, m_object);
+    m_out = json_sprint(&m_object, 0);
+    EXPECT_STREQ("[null]", m_out);
+}
+
+TEST_F(json_init_from_buf_tests, long_strings_with_escapes_positive)
+{
+    log_trace_func();
+    for (size_t prefix = 0; prefix < 70; prefix++) {
+        std::string plain(prefix, 'x');
+        std::string str = "[\"" + plain + "\\n" + plain + "\\\"\\u0398" + plain + "\"]";
+        std::string expected = "[\"" + plain + "\n" + plain + "\\\"Θ" + plain + "\"]";
+        m_object = json_init_from_buf(str.data(), str.size(), &m_consumed);
+        ASSERT_NE(nullptr, m_object);
+        EXPECT_EQ(str.size(), m_consumed);
+        m_out = json_sprint(&m_object, 0);
+        EXPECT_EQ(expected, m_out);
+        free(m_out);
+        m_out = nullptr;
+        json_deinit(&m_object);
+    }
+}
+
+TEST_F(json_init_from_buf_tests, same_result_as_str_positive)
+{
+    log_trace_func();
+    const std::string str = R"JSON({"a":[1,2.5e3,"Θ"],"b":{"c":null,"d":false}})JSON";
+    m_object = json_init_from_buf(str.data(), str.size(), &m_consumed);
+    ASSERT_NE(nullptr, m_object);
+    EXPECT_EQ(str.size(), m_consumed);
+    json_t* from_str = json_init_from_str(str.c_str(), nullptr);
+    ASSERT_NE(nullptr, from_str);
+    m_out = json_sprint(&m_object, 0);
+    char* out_str = json_sprint(&from_str, 0);
+    EXPECT_STREQ(out_str, m_out);
+    free(out_str);
+    json_deinit(&from_str);
+}
+
+TEST_F(json_init_from_buf_tests, str_longer_than_window_positive)
+{
+    log_trace_func();
+    std::string str = "[";
+    std::string expected = "[";
+    for (size_t i = 0; str.size() < 3 * 64 * 1024; i++) {
+        std::string item = "\"" + std::string(i % 13, 's') + "\"," + std::to_string(i * 7919) + ",";
+        str += "  " + item;
+        expected += item;
+    }
+    str += "null] [1]";
+    expected += "null]";
+    const char* end = nullptr;
+    m_object = json_init_from_str(str.c_str(), &end);
+    ASSERT_NE(nullptr, m_object);
+    EXPECT_STREQ(" [1]", end);
+    m_out = json_sprint(&m_object, 0);
+    EXPECT_EQ(expected, m_out);
+}
+
+TEST_F(json_init_from_buf_tests, indented_same_result_as_str_positive)
+{
+    log_trace_func();
+    // escaped quotes, brackets and spaces inside of strings cross blocks of space scanner
+    std::string str = "[\n";
+    for (size_t i = 0; str.size() < 5 * 4096; i++) {
+        std::string body = std::string(i % 67, ' ') + "[{:,}]" + std::string(2 * (i % 3), '\\') + "\\\"" + std::string(i % 5, ' ');
+        str += std::string(i % 9, ' ') + "{\"k" + std::to_string(i) + "\" :\t\"" + body + "\",\n    \"n\": [ " + std::to_string(i) + " , true ,null ] },\r\n";
+    }
+    str += "  -1.5e3\n]  ";
+    m_object = json_init_from_buf(str.data(), str.size(), &m_consumed);
+    ASSERT_NE(nullptr, m_object);
+    EXPECT_EQ(str.size() - 2, m_consumed);
+    json_t* from_str = json_init_from_str(str.c_str(), nullptr);
+    ASSERT_NE(nullptr, from_str);
+    m_out = json_sprint(&m_object, 0);
+    char* out_str = json_sprint(&from_str, 0);
+    EXPECT_STREQ(out_str, m_out);
+    free(out_str);
+    json_deinit(&from_str);
+}
+}
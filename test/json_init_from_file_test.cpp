@@ -4,6 +4,7 @@
 #include "json_printer.h"
 #include "log.h"
 #include <stdio.h>
+#include <unistd.h>
 
 namespace json_test {
 
@@ -66,4 +67,46 @@ TEST_F(json_init_from_file_tests, negative)
     m_object = json_init_from_file(m_fin);
     ASSERT_EQ(nullptr, m_object);
 }
-}
\ No newline at end of file
+
+const char JSON_SEQUENCE_STRING[] = "[1] 23 \"4\"{\"5\":5}";
+
+TEST_F(json_init_from_file_tests, positive_sequence)
+{
+    m_fin = fmemopen(const_cast<char*>(JSON_SEQUENCE_STRING), sizeof(JSON_SEQUENCE_STRING) - 1, "r");
+    ASSERT_NE(nullptr, m_fin);
+    const char* expected[] = { "[1]", "23", "\"4\"", "{\"5\":5}" };
+    for (auto value : expected) {
+        m_object = json_init_from_file(m_fin);
+        ASSERT_NE(nullptr, m_object);
+        m_out = json_sprint(&m_object, 0);
+        EXPECT_STREQ(value, m_out);
+        free(m_out);
+        m_out = nullptr;
+        json_deinit(&m_object);
+    }
+    EXPECT_EQ(EOF, fgetc(m_fin));
+}
+
+const char JSON_PIPE_SEQUENCE_STRING[] = "[1] 23\"4\"{\"5\":5}6";
+
+TEST_F(json_init_from_file_tests, positive_pipe_sequence)
+{
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    ASSERT_EQ((ssize_t)sizeof(JSON_PIPE_SEQUENCE_STRING) - 1, write(fds[1], JSON_PIPE_SEQUENCE_STRING, sizeof(JSON_PIPE_SEQUENCE_STRING) - 1));
+    close(fds[1]);
+    m_fin = fdopen(fds[0], "r");
+    ASSERT_NE(nullptr, m_fin);
+    const char* expected[] = { "[1]", "23", "\"4\"", "{\"5\":5}", "6" };
+    for (auto value : expected) {
+        m_object = json_init_from_file(m_fin);
+        ASSERT_NE(nullptr, m_object);
+        m_out = json_sprint(&m_object, 0);
+        EXPECT_STREQ(value, m_out);
+        free(m_out);
+        m_out = nullptr;
+        json_deinit(&m_object);
+    }
+    EXPECT_EQ(EOF, fgetc(m_fin));
+}
+}
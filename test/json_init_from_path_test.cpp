@@ -0,0 +1,92 @@
+/// Copyright © Alexander Kaluzhnyy
+#include <gtest/gtest.h>
+#include "json.h"
+#include "json_printer.h"
+#include "log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+
+namespace json_test {
+
+using namespace ::testing;
+
+class json_init_from_path_tests : public Test {
+protected:
+    char m_path[32] = "/tmp/json_path_testXXXXXX";
+    json_t* m_object = nullptr;
+    char* m_out = nullptr;
+    void SetUp() override
+    {
+        int fd = mkstemp(m_path);
+        ASSERT_GE(fd, 0);
+        close(fd);
+    }
+    void TearDown() override
+    {
+        unlink(m_path);
+        free(m_out);
+        json_deinit(&m_object);
+    }
+    void write_file(const std::string& str)
+    {
+        FILE* file = fopen(m_path, "w");
+        ASSERT_NE(nullptr, file);
+        EXPECT_EQ(str.size(), fwrite(str.data(), sizeof(char), str.size(), file));
+        fclose(file);
+    }
+};
+
+TEST_F(json_init_from_path_tests, positive)
+{
+    log_trace_func();
+    write_file(" {\"key\":[1,\"value\",null]}\n\t ");
+    m_object = json_init_from_path(m_path);
+    ASSERT_NE(nullptr, m_object);
+    m_out = json_sprint(&m_object, 0);
+    EXPECT_STREQ("{\"key\":[1,\"value\",null]}", m_out);
+}
+
+TEST_F(json_init_from_path_tests, number_at_end_positive)
+{
+    log_trace_func();
+    write_file("-12.5");
+    m_object = json_init_from_path(m_path);
+    ASSERT_NE(nullptr, m_object);
+    EXPECT_STREQ("-12.5", json_get_str(&m_object));
+}
+
+TEST_F(json_init_from_path_tests, symbols_after_value_negative)
+{
+    log_trace_func();
+    write_file("[1] [2]");
+    EXPECT_EQ(nullptr, json_init_from_path(m_path));
+}
+
+TEST_F(json_init_from_path_tests, empty_negative)
+{
+    log_trace_func();
+    EXPECT_EQ(nullptr, json_init_from_path(m_path));
+}
+
+TEST_F(json_init_from_path_tests, not_exist_negative)
+{
+    log_trace_func();
+    EXPECT_EQ(nullptr, json_init_from_path("/nonexistent/json_path_test"));
+}
+
+TEST_F(json_init_from_path_tests, not_regular_positive)
+{
+    log_trace_func();
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    ASSERT_EQ(3, write(fds[1], "[7]", 3));
+    close(fds[1]);
+    m_object = json_init_from_path(("/proc/self/fd/" + std::to_string(fds[0])).c_str());
+    close(fds[0]);
+    ASSERT_NE(nullptr, m_object);
+    m_out = json_sprint(&m_object, 0);
+    EXPECT_STREQ("[7]", m_out);
+}
+}
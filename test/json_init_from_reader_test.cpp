@@ -0,0 +1,94 @@
+/// Copyright © Alexander Kaluzhnyy
+#include <gtest/gtest.h>
+#include "json.h"
+#include "json_printer.h"
+#include "log.h"
+#include <string>
+#include <unistd.h>
+
+namespace json_test {
+
+using namespace ::testing;
+
+struct chunked_source {
+    std::string data;
+    size_t chunk;
+    size_t pos = 0;
+};
+
+static size_t chunked_read(void* data, char* buf, size_t size)
+{
+    auto source = static_cast<chunked_source*>(data);
+    size_t len = std::min({ size, source->chunk, source->data.size() - source->pos });
+    memcpy(buf, source->data.data() + source->pos, len);
+    source->pos += len;
+    return len;
+}
+
+class json_init_from_reader_tests : public TestWithParam<size_t> {
+protected:
+    json_t* m_object = nullptr;
+    char* m_out = nullptr;
+    void TearDown() override
+    {
+        free(m_out);
+        json_deinit(&m_object);
+    }
+};
+
+static const char JSON_READER_DOCUMENT[] = R"JSON( {"key":[null,true,false,123.5e-1,"str\"ing Θ"],"":{}} )JSON";
+static const char JSON_READER_DOCUMENT_EXPECTED[] = R"JSON({"key":[null,true,false,123.5e-1,"str\"ing Θ"],"":{}})JSON";
+
+TEST_P(json_init_from_reader_tests, chunked_positive)
+{
+    log_trace_func();
+    chunked_source source = { JSON_READER_DOCUMENT, GetParam() };
+    m_object = json_init_from_reader(chunked_read, &source);
+    ASSERT_NE(nullptr, m_object);
+    m_out = json_sprint(&m_object, 0);
+    EXPECT_STREQ(JSON_READER_DOCUMENT_EXPECTED, m_out);
+}
+
+TEST_P(json_init_from_reader_tests, chunked_number_positive)
+{
+    log_trace_func();
+    chunked_source source = { "-1234567.125", GetParam() };
+    m_object = json_init_from_reader(chunked_read, &source);
+    ASSERT_NE(nullptr, m_object);
+    m_out = json_sprint(&m_object, 0);
+    EXPECT_STREQ("-1234567.125", m_out);
+}
+
+TEST_P(json_init_from_reader_tests, chunked_negative)
+{
+    log_trace_func();
+    chunked_source source = { "[1,2,", GetParam() };
+    m_object = json_init_from_reader(chunked_read, &source);
+    EXPECT_EQ(nullptr, m_object);
+}
+
+INSTANTIATE_TEST_SUITE_P(chunks, json_init_from_reader_tests, Values(1, 2, 3, 7, 64 * 1024));
+
+TEST(json_init_from_fd_tests, pipe_positive)
+{
+    log_trace_func();
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    const char value[] = R"JSON(["pipe",{"fd":1}])JSON";
+    ASSERT_EQ((ssize_t)sizeof(value) - 1, write(fds[1], value, sizeof(value) - 1));
+    close(fds[1]);
+    json_t* object = json_init_from_fd(fds[0]);
+    close(fds[0]);
+    ASSERT_NE(nullptr, object);
+    char* out = json_sprint(&object, 0);
+    EXPECT_STREQ(value, out);
+    free(out);
+    json_deinit(&object);
+}
+
+TEST(json_init_from_fd_tests, wrong_fd_negative)
+{
+    log_trace_func();
+    EXPECT_EQ(nullptr, json_init_from_fd(-1));
+}
+}
@@ -15,7 +15,10 @@ protected:
 };
 
 #define NOT_JSON "qwerty"
+#ifndef JSON_NO_LOG
+// not expanded by tests, build without logs reports it as unused
 #define JSON_STR
+#endif
 
 #define json_init_from_str_negative_tests_base(str, endptr_value)                \
     TEST_F(json_init_from_str_negative_tests, json_init_from_1_##str##_negative) \
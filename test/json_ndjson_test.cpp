@@ -0,0 +1,135 @@
+/// Copyright © Alexander Kaluzhnyy
+#include <gtest/gtest.h>
+#include "json.h"
+#include "json_ndjson.h"
+#include "json_printer.h"
+#include "log.h"
+#include <algorithm>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace json_test {
+
+using namespace ::testing;
+
+struct ndjson_result {
+    std::vector<size_t> lines;
+    std::vector<std::string> values;
+    size_t stop_after = SIZE_MAX;
+};
+
+static int ndjson_collect(void* data, size_t line, json_t* value)
+{
+    auto result = static_cast<ndjson_result*>(data);
+    result->lines.push_back(line);
+    if (value != nullptr) {
+        char* str = json_sprint(&value, 0);
+        result->values.push_back(str);
+        free(str);
+        json_deinit(&value);
+    } else {
+        result->values.push_back("NULL");
+    }
+    return result->lines.size() >= result->stop_after;
+}
+
+static std::string ndjson_document(size_t records)
+{
+    std::string str;
+    for (size_t i = 0; i < records; i++) {
+        str += "{\"id\":" + std::to_string(i) + ",\"v\":[\"s" + std::to_string(i) + "\"]}\n";
+    }
+    return str;
+}
+
+class json_ndjson_tests : public TestWithParam<size_t> {
+protected:
+    ndjson_result m_result;
+    FILE* m_fin = nullptr;
+    void TearDown() override
+    {
+        if (m_fin != nullptr) {
+            fclose(m_fin);
+        }
+    }
+    void check_ordered(size_t records)
+    {
+        ASSERT_EQ(records, m_result.values.size());
+        for (size_t i = 0; i < records; i++) {
+            EXPECT_EQ(i, m_result.lines[i]);
+            EXPECT_EQ("{\"id\":" + std::to_string(i) + ",\"v\":[\"s" + std::to_string(i) + "\"]}", m_result.values[i]);
+        }
+    }
+};
+
+static const size_t NDJSON_RECORDS = 300;
+
+TEST_P(json_ndjson_tests, ordered_buf_positive)
+{
+    log_trace_func();
+    const std::string str = ndjson_document(NDJSON_RECORDS);
+    EXPECT_EQ(0, json_ndjson_parse_buf(str.data(), str.size(), GetParam(), 1, ndjson_collect, &m_result));
+    check_ordered(NDJSON_RECORDS);
+}
+
+TEST_P(json_ndjson_tests, ordered_file_positive)
+{
+    log_trace_func();
+    std::string str = ndjson_document(NDJSON_RECORDS);
+    m_fin = fmemopen(str.data(), str.size(), "r");
+    ASSERT_NE(nullptr, m_fin);
+    EXPECT_EQ(0, json_ndjson_parse_file(m_fin, GetParam(), 1, ndjson_collect, &m_result));
+    check_ordered(NDJSON_RECORDS);
+}
+
+TEST_P(json_ndjson_tests, unordered_buf_positive)
+{
+    log_trace_func();
+    const std::string str = ndjson_document(NDJSON_RECORDS);
+    EXPECT_EQ(0, json_ndjson_parse_buf(str.data(), str.size(), GetParam(), 0, ndjson_collect, &m_result));
+    ASSERT_EQ(NDJSON_RECORDS, m_result.values.size());
+    std::vector<size_t> lines = m_result.lines;
+    std::sort(lines.begin(), lines.end());
+    for (size_t i = 0; i < NDJSON_RECORDS; i++) {
+        EXPECT_EQ(i, lines[i]);
+    }
+}
+
+TEST_P(json_ndjson_tests, wrong_and_blank_lines_positive)
+{
+    log_trace_func();
+    const std::string str = "[1]\n\n  \r\n{\"a\":}\n\"s\" 1\n  true  \r\n4";
+    EXPECT_EQ(0, json_ndjson_parse_buf(str.data(), str.size(), GetParam(), 1, ndjson_collect, &m_result));
+    EXPECT_EQ(std::vector<size_t>({ 0, 3, 4, 5, 6 }), m_result.lines);
+    EXPECT_EQ(std::vector<std::string>({ "[1]", "NULL", "NULL", "true", "4" }), m_result.values);
+}
+
+TEST_P(json_ndjson_tests, stop_negative)
+{
+    log_trace_func();
+    const std::string str = ndjson_document(NDJSON_RECORDS);
+    m_result.stop_after = 10;
+    EXPECT_EQ(-1, json_ndjson_parse_buf(str.data(), str.size(), GetParam(), 1, ndjson_collect, &m_result));
+    check_ordered(10);
+}
+
+INSTANTIATE_TEST_SUITE_P(threads, json_ndjson_tests, Values(0, 1, 4));
+
+TEST(json_ndjson, empty_positive)
+{
+    log_trace_func();
+    ndjson_result result;
+    EXPECT_EQ(0, json_ndjson_parse_buf("", 0, 2, 1, ndjson_collect, &result));
+    EXPECT_EQ(0u, result.values.size());
+}
+
+TEST(json_ndjson, nullptr_negative)
+{
+    log_trace_func();
+    ndjson_result result;
+    EXPECT_EQ(-1, json_ndjson_parse_buf(nullptr, 0, 2, 1, ndjson_collect, &result));
+    EXPECT_EQ(-1, json_ndjson_parse_buf("1", 1, 2, 1, nullptr, &result));
+    EXPECT_EQ(-1, json_ndjson_parse_file(nullptr, 2, 1, ndjson_collect, &result));
+}
+}
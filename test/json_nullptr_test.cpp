@@ -6,6 +6,7 @@
 
 #include <cstdint>
 #include "json.h"
+#include "json_parser.h"
 
 namespace json_test {
 
@@ -67,21 +68,104 @@ json_nullptr_test_impl(nullptr, json_init_from_value, nullptr, WRONG_STRING_PTR)
 json_nullptr_test_impl(nullptr, json_init_from, nullptr, nullptr);
 json_nullptr_test_impl(nullptr, json_init_from, nullptr, WRONG_POINTER);
 
+// json_t* json_init_from_reader(json_read_t read, void* data);
+json_nullptr_test_impl(nullptr, json_init_from_reader, nullptr, nullptr);
+json_nullptr_test_impl(nullptr, json_init_from_reader, nullptr, WRONG_POINTER);
+
 // json_t* json_init_from_file(FILE* file);
 json_nullptr_test_impl(nullptr, json_init_from_file, nullptr);
 
+// json_t* json_init_from_path(const char* path);
+json_nullptr_test_impl(nullptr, json_init_from_path, nullptr);
+
+// json_t* json_init_from_buf_projected(const char* data, size_t len, const char* const* paths, size_t count);
+TEST_F(json_nullptr_test, json_init_from_buf_projected_nullptr_negative)
+{
+    const char* paths[] = { "" };
+    EXPECT_EQ(nullptr, json_init_from_buf_projected(nullptr, 0, paths, 1));
+    EXPECT_EQ(nullptr, json_init_from_buf_projected(WRONG_STRING_PTR, 0, nullptr, 0));
+}
+
 // json_t* json_init_from_str(const char* value, const char** endptr);
 json_nullptr_test_impl(nullptr, json_init_from_str, nullptr, nullptr);
 
+// json_t* json_init_from_buf(const char* data, size_t len, size_t* consumed);
+json_nullptr_test_impl(nullptr, json_init_from_buf, nullptr, 0, nullptr);
+
+// json_t* json_parser_parse_buf(json_parser_t* self, const char* data, size_t len, size_t* consumed);
+TEST_F(json_nullptr_test, json_parser_parse_buf_p1_nullptr_negative)
+{
+    EXPECT_EQ(nullptr, json_parser_parse_buf(nullptr, WRONG_STRING_PTR, 0, nullptr));
+}
+
+// json_t* json_parser_parse_insitu(json_parser_t* self, char* data, size_t len, size_t* consumed);
+TEST_F(json_nullptr_test, json_parser_parse_insitu_nullptr_negative)
+{
+    json_parser_t* parser = json_parser_init();
+    char data[] = "1";
+    EXPECT_EQ(nullptr, json_parser_parse_insitu(nullptr, data, 1, nullptr));
+    EXPECT_EQ(nullptr, json_parser_parse_insitu(parser, nullptr, 0, nullptr));
+    json_parser_deinit(&parser);
+}
+
+// json_t* json_parser_parse_reader(json_parser_t* self, json_read_t read, void* data);
+json_nullptr_test_impl(nullptr, json_parser_parse_reader, nullptr, nullptr, nullptr);
+
+// int json_parser_sax_buf(json_parser_t* self, const json_sax_t* sax, void* user_data, const char* data, size_t len, size_t* consumed);
+TEST_F(json_nullptr_test, json_parser_sax_buf_nullptr_negative)
+{
+    json_parser_t* parser = json_parser_init();
+    json_sax_t sax = {};
+    EXPECT_EQ(-1, json_parser_sax_buf(nullptr, &sax, nullptr, WRONG_STRING_PTR, 0, nullptr));
+    EXPECT_EQ(-1, json_parser_sax_buf(parser, nullptr, nullptr, WRONG_STRING_PTR, 0, nullptr));
+    EXPECT_EQ(-1, json_parser_sax_buf(parser, &sax, nullptr, nullptr, 0, nullptr));
+    json_parser_deinit(&parser);
+}
+
+// int json_parser_sax_reader(json_parser_t* self, const json_sax_t* sax, void* user_data, json_read_t read, void* data);
+TEST_F(json_nullptr_test, json_parser_sax_reader_nullptr_negative)
+{
+    json_parser_t* parser = json_parser_init();
+    json_sax_t sax = {};
+    EXPECT_EQ(-1, json_parser_sax_reader(nullptr, &sax, nullptr, (json_read_t)WRONG_POINTER, nullptr));
+    EXPECT_EQ(-1, json_parser_sax_reader(parser, nullptr, nullptr, (json_read_t)WRONG_POINTER, nullptr));
+    EXPECT_EQ(-1, json_parser_sax_reader(parser, &sax, nullptr, nullptr, nullptr));
+    json_parser_deinit(&parser);
+}
+
+// json_push_status_t json_push_feed(json_push_parser_t* self, const char* data, size_t len, size_t* consumed);
+TEST_F(json_nullptr_test, json_push_feed_p1_nullptr_negative)
+{
+    EXPECT_EQ(JSON_PUSH_ERROR, json_push_feed(nullptr, WRONG_STRING_PTR, 0, nullptr));
+}
+
+// json_push_status_t json_push_finish(json_push_parser_t* self);
+json_nullptr_test_impl(JSON_PUSH_ERROR, json_push_finish, nullptr);
+
+// json_t* json_push_take(json_push_parser_t* self);
+json_nullptr_test_impl(nullptr, json_push_take, nullptr);
+
 // json_t* json_copy(json_t** self);
 json_nullptr_test_impl_json_1(nullptr, json_copy);
 
+// json_t* json_copy_shared(json_t** self);
+json_nullptr_test_impl_json_1(nullptr, json_copy_shared);
+
 // const char* json_get_type(json_t** self);
 json_nullptr_test_impl_json_1(nullptr, json_get_type);
 
 // const char* json_get_str(json_t** self);
 json_nullptr_test_impl_json_1(nullptr, json_get_str);
 
+// const char* json_get_strn(json_t** self, size_t* len);
+json_nullptr_test_impl_json_1(nullptr, json_get_strn, nullptr);
+
+// int json_get_int64(json_t** self, int64_t* value);
+json_nullptr_test_impl_json_1(-1, json_get_int64, nullptr);
+
+// int json_get_double(json_t** self, double* value);
+json_nullptr_test_impl_json_1(-1, json_get_double, nullptr);
+
 // size_t json_size(json_t** self);
 json_nullptr_test_impl_json_1(0, json_size);
 
@@ -91,6 +175,9 @@ json_nullptr_test_impl_json_2(nullptr, json_set);
 // json_t** json_get_by_id(json_t** self, size_t id);
 json_nullptr_test_impl_json_1(0, json_get_by_id, 0);
 
+// json_t** json_get_mut_by_id(json_t** self, size_t id);
+json_nullptr_test_impl_json_1(0, json_get_mut_by_id, 0);
+
 // json_t** json_set_by_id(json_t** self, json_t** value, size_t id);
 json_nullptr_test_impl_json_2(nullptr, json_set_by_id, 0);
 
@@ -102,11 +189,22 @@ json_nullptr_test_impl_json_1(nullptr, json_get_by_key, nullptr);
 json_nullptr_test_impl_json_1(nullptr, json_get_by_key, WRONG_STRING_PTR);
 json_nullptr_test_impl(nullptr, json_get_by_key, WRONG_JSON_PPTR, nullptr);
 
+// json_t** json_get_mut_by_key(json_t** self, const char* key);
+json_nullptr_test_impl_json_1(nullptr, json_get_mut_by_key, nullptr);
+json_nullptr_test_impl_json_1(nullptr, json_get_mut_by_key, WRONG_STRING_PTR);
+json_nullptr_test_impl(nullptr, json_get_mut_by_key, WRONG_JSON_PPTR, nullptr);
+
 // json_t** json_set_by_key(json_t** self_ptr, json_t** value, const char* key);
 json_nullptr_test_impl_json_2(nullptr, json_set_by_key, nullptr);
 json_nullptr_test_impl_json_2(nullptr, json_set_by_key, WRONG_STRING_PTR);
 json_nullptr_test_impl(nullptr, json_set_by_key, WRONG_JSON_PPTR, WRONG_JSON_PPTR, nullptr);
 
+// json_t** json_reserve(json_t** self, size_t capacity);
+json_nullptr_test_impl_json_1(nullptr, json_reserve, 1);
+
+// json_t** json_shrink_to_fit(json_t** self);
+json_nullptr_test_impl_json_1(nullptr, json_shrink_to_fit);
+
 // void json_deinit(json_t** self);
 TEST_F(json_nullptr_test, json_deinit_p1_nullptr_negative)
 {
@@ -117,4 +215,15 @@ TEST_F(json_nullptr_test, json_deinit_p1_NULL_JSON_PPTR_negative)
     json_deinit(NULL_JSON_PPTR);
 }
 
+// void json_parser_deinit(json_parser_t** self);
+TEST_F(json_nullptr_test, json_parser_deinit_p1_nullptr_negative)
+{
+    json_parser_deinit(nullptr);
+}
+TEST_F(json_nullptr_test, json_parser_deinit_p1_NULL_PPTR_negative)
+{
+    json_parser_t* parser = nullptr;
+    json_parser_deinit(&parser);
+}
+
 }
\ No newline at end of file
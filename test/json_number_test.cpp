@@ -0,0 +1,157 @@
+/// Copyright © Alexander Kaluzhnyy
+#include <gtest/gtest.h>
+#include "json.h"
+#include "log.h"
+#include <cmath>
+#include <cstdint>
+#include <clocale>
+#include <cstdlib>
+#include <string>
+
+namespace json_test {
+
+using namespace ::testing;
+
+class json_number_tests : public Test {
+protected:
+    json_t* m_value = nullptr;
+    void TearDown() override
+    {
+        json_deinit(&m_value);
+    }
+    void parse(const std::string& str)
+    {
+        json_deinit(&m_value);
+        m_value = json_init_from_buf(str.data(), str.size(), nullptr);
+        ASSERT_NE(nullptr, m_value);
+    }
+};
+
+TEST_F(json_number_tests, int64_positive)
+{
+    log_trace_func();
+    const std::pair<std::string, int64_t> values[] = {
+        { "0", 0 },
+        { "-1", -1 },
+        { "1234567890", 1234567890 },
+        { "9223372036854775807", INT64_MAX },
+        { "-9223372036854775808", INT64_MIN },
+        { "1.0", 1 },
+        { "2e3", 2000 },
+        { "-0", 0 },
+    };
+    for (auto& [str, expected] : values) {
+        parse(str);
+        int64_t value = 42;
+        EXPECT_EQ(0, json_get_int64(&m_value, &value)) << str;
+        EXPECT_EQ(expected, value) << str;
+    }
+}
+
+TEST_F(json_number_tests, int64_negative)
+{
+    log_trace_func();
+    for (auto str : { "1.5", "25e-1", "9223372036854775808", "-9223372036854775809", "1e20", "1e400" }) {
+        parse(str);
+        int64_t value = 42;
+        EXPECT_EQ(-1, json_get_int64(&m_value, &value)) << str;
+        EXPECT_EQ(42, value) << str;
+    }
+}
+
+TEST_F(json_number_tests, double_positive)
+{
+    log_trace_func();
+    // fast path, long mantissas, big and small exponents, denormals
+    for (auto str : { "0", "-0.0", "1.5", "-12.5e1", "0.1", "3.141592653589793", "1e22", "1e23", "123456789012345678901234567890",
+             "0.000000000000000000000000000001", "2.2250738585072014e-308", "4.9e-324", "1.7976931348623157e308", "1e-400",
+             "9007199254740993", "18446744073709551615", "12345678901234567.890e-3" }) {
+        parse(str);
+        double value = 42;
+        EXPECT_EQ(0, json_get_double(&m_value, &value)) << str;
+        EXPECT_EQ(strtod(str, nullptr), value) << str;
+        EXPECT_EQ(std::signbit(strtod(str, nullptr)), std::signbit(value)) << str;
+    }
+}
+
+TEST_F(json_number_tests, double_locale_positive)
+{
+    log_trace_func();
+    // mantissas beyond 2^53 and exponents beyond 22 are converted by strtod
+    const char* strs[] = { "1.5e30", "-2.5e-30", "9007199254740993.5", "12345678901234567.890e-3" };
+    double expected[std::size(strs)];
+    for (size_t i = 0; i < std::size(strs); i++) {
+        expected[i] = strtod(strs[i], nullptr);
+    }
+    const std::string saved = setlocale(LC_NUMERIC, nullptr);
+    const char* locale = nullptr;
+    for (auto name : { "de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "fr_FR.utf8", "ru_RU.UTF-8", "ru_RU.utf8", "de_DE", "fr_FR" }) {
+        locale = setlocale(LC_NUMERIC, name);
+        if (locale != nullptr && strtod("1.5", nullptr) != 1.5) {
+            break;
+        }
+        locale = nullptr;
+    }
+    if (locale == nullptr) {
+        setlocale(LC_NUMERIC, saved.c_str());
+        GTEST_SKIP() << "no locale with decimal comma";
+    }
+    for (size_t i = 0; i < std::size(strs); i++) {
+        parse(strs[i]);
+        double value = 42;
+        EXPECT_EQ(0, json_get_double(&m_value, &value)) << strs[i];
+        EXPECT_EQ(expected[i], value) << strs[i];
+    }
+    setlocale(LC_NUMERIC, saved.c_str());
+}
+
+TEST_F(json_number_tests, double_negative)
+{
+    log_trace_func();
+    for (auto str : { "1e400", "-1.8e308" }) {
+        parse(str);
+        double value = 42;
+        EXPECT_EQ(-1, json_get_double(&m_value, &value)) << str;
+        EXPECT_EQ(42, value) << str;
+    }
+}
+
+TEST_F(json_number_tests, not_number_negative)
+{
+    log_trace_func();
+    for (auto str : { "\"1\"", "null", "true", "[1]", "{}" }) {
+        parse(str);
+        int64_t i = 42;
+        double d = 42;
+        EXPECT_EQ(-1, json_get_int64(&m_value, &i)) << str;
+        EXPECT_EQ(-1, json_get_double(&m_value, &d)) << str;
+    }
+}
+
+TEST_F(json_number_tests, init_from_value_positive)
+{
+    log_trace_func();
+    m_value = json_init_from_value("number", "-7");
+    ASSERT_NE(nullptr, m_value);
+    int64_t value = 0;
+    EXPECT_EQ(0, json_get_int64(&m_value, &value));
+    EXPECT_EQ(-7, value);
+    EXPECT_STREQ("-7", json_get_str(&m_value));
+    json_t* copy = json_copy(&m_value);
+    value = 0;
+    EXPECT_EQ(0, json_get_int64(&copy, &value));
+    EXPECT_EQ(-7, value);
+    json_deinit(&copy);
+}
+
+TEST_F(json_number_tests, nested_positive)
+{
+    log_trace_func();
+    parse(R"({"a":[1,2.5]})");
+    json_t** node = json_get_by_id(json_get_by_key(&m_value, "a"), 1);
+    ASSERT_NE(nullptr, node);
+    double value = 0;
+    EXPECT_EQ(0, json_get_double(node, &value));
+    EXPECT_EQ(2.5, value);
+}
+}
@@ -0,0 +1,144 @@
+/// Copyright © Alexander Kaluzhnyy
+#include <gtest/gtest.h>
+#include "json.h"
+#include "json_parser.h"
+#include "json_printer.h"
+#include "log.h"
+#include "system_mock.hpp"
+#include <string>
+
+namespace json_test {
+
+using namespace ::testing;
+
+class json_parser_tests : public Test {
+protected:
+    json_parser_t* m_parser = nullptr;
+    json_t* m_object = nullptr;
+    char* m_out = nullptr;
+    void SetUp() override
+    {
+        m_parser = json_parser_init();
+        ASSERT_NE(nullptr, m_parser);
+    }
+    void TearDown() override
+    {
+        free(m_out);
+        json_deinit(&m_object);
+        json_parser_deinit(&m_parser);
+        EXPECT_EQ(nullptr, m_parser);
+    }
+    void parse_and_check(const std::string& str, const char* expected)
+    {
+        size_t consumed = 0;
+        m_object = json_parser_parse_buf(m_parser, str.data(), str.size(), &consumed);
+        ASSERT_NE(nullptr, m_object);
+        EXPECT_EQ(str.size(), consumed);
+        m_out = json_sprint(&m_object, 0);
+        EXPECT_STREQ(expected, m_out);
+        free(m_out);
+        m_out = nullptr;
+        json_deinit(&m_object);
+    }
+};
+
+TEST_F(json_parser_tests, reuse_positive)
+{
+    log_trace_func();
+    parse_and_check(R"JSON({"key":"value"})JSON", R"JSON({"key":"value"})JSON");
+    parse_and_check("[1,2,3]", "[1,2,3]");
+    parse_and_check("\"" + std::string(1000, 'x') + "\"", ("\"" + std::string(1000, 'x') + "\"").c_str());
+    parse_and_check("\"short\"", "\"short\"");
+    parse_and_check("-1.5e3", "-1.5e3");
+}
+
+TEST_F(json_parser_tests, error_does_not_break_parser_positive)
+{
+    log_trace_func();
+    EXPECT_EQ(nullptr, json_parser_parse_buf(m_parser, "[\"abc", 5, nullptr));
+    parse_and_check("[\"abc\"]", "[\"abc\"]");
+}
+
+TEST_F(json_parser_tests, scratch_buffer_reused_positive)
+{
+    log_trace_func();
+    const std::string str = "\"" + std::string(1000, 's') + "\"";
+    parse_and_check(str, str.c_str());
+    NiceMock<system_mock> mock;
+    EXPECT_CALL(mock, realloc(_, _)).Times(0);
+    parse_and_check(str, str.c_str());
+}
+
+TEST_F(json_parser_tests, container_allocated_once_positive)
+{
+    log_trace_func();
+    std::string str = "[";
+    for (size_t i = 0; i < 500; i++) {
+        str += "true,";
+    }
+    str.back() = ']';
+    parse_and_check(str, str.c_str());
+    NiceMock<system_mock> mock;
+    EXPECT_CALL(mock, realloc(_, _)).Times(0);
+    EXPECT_CALL(mock, calloc(_, _)).Times(1);
+    m_object = json_parser_parse_buf(m_parser, str.data(), str.size(), nullptr);
+    ASSERT_NE(nullptr, m_object);
+    EXPECT_EQ(500u, json_size(&m_object));
+}
+
+TEST_F(json_parser_tests, keys_interned_positive)
+{
+    log_trace_func();
+    std::string str = "[";
+    for (size_t i = 0; i < 100; i++) {
+        str += R"JSON({"id":true,"name":false},)JSON";
+    }
+    str.back() = ']';
+    parse_and_check(str, str.c_str());
+    NiceMock<system_mock> mock;
+    // array, objects and 2 keys
+    EXPECT_CALL(mock, calloc(_, _)).Times(1 + 100 + 2);
+    m_object = json_parser_parse_buf(m_parser, str.data(), str.size(), nullptr);
+    ASSERT_NE(nullptr, m_object);
+    EXPECT_EQ(json_key(json_get_by_id(&m_object, 0), 1), json_key(json_get_by_id(&m_object, 99), 1));
+}
+
+TEST_F(json_parser_tests, keep_keys_positive)
+{
+    log_trace_func();
+    json_parser_set_keep_keys(m_parser, 1);
+    m_object = json_parser_parse_buf(m_parser, R"JSON({"key":1})JSON", 9, nullptr);
+    ASSERT_NE(nullptr, m_object);
+    json_t* other = json_parser_parse_buf(m_parser, R"JSON({"key":2})JSON", 9, nullptr);
+    ASSERT_NE(nullptr, other);
+    EXPECT_EQ(json_key(&m_object, 0), json_key(&other, 0));
+    json_deinit(&m_object);
+    json_parser_set_keep_keys(m_parser, 0);
+    EXPECT_STREQ("key", json_key(&other, 0));
+    json_deinit(&other);
+    parse_and_check(R"JSON({"key":3,"k":{"key":4}})JSON", R"JSON({"key":3,"k":{"key":4}})JSON");
+}
+
+static size_t read_str(const char** str, char* buf, size_t size)
+{
+    size_t len = std::min(strlen(*str), size);
+    memcpy(buf, *str, len);
+    *str += len;
+    return len;
+}
+
+TEST_F(json_parser_tests, reader_positive)
+{
+    log_trace_func();
+    for (const char* value : { "[true]", "{\"a\":null}", "\"b\"" }) {
+        const char* iterator = value;
+        m_object = json_parser_parse_reader(m_parser, (json_read_t)read_str, &iterator);
+        ASSERT_NE(nullptr, m_object);
+        m_out = json_sprint(&m_object, 0);
+        EXPECT_STREQ(value, m_out);
+        free(m_out);
+        m_out = nullptr;
+        json_deinit(&m_object);
+    }
+}
+}
@@ -0,0 +1,160 @@
+/// Copyright © Alexander Kaluzhnyy
+#include <gtest/gtest.h>
+#include "json.h"
+#include "json_parser.h"
+#include "json_pool.h"
+#include "json_printer.h"
+#include "log.h"
+#include "system_mock.hpp"
+#include <pthread.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace json_test {
+
+using namespace ::testing;
+
+class json_pool_tests : public Test {
+protected:
+    void SetUp() override
+    {
+        json_pool_set_enabled(1);
+    }
+    void TearDown() override
+    {
+        json_pool_set_enabled(0);
+        json_pool_trim();
+    }
+    static std::string print(json_t** value)
+    {
+        char* str = json_sprint(value, 0);
+        std::string ret = str != nullptr ? str : "NULL";
+        free(str);
+        return ret;
+    }
+};
+
+static const char JSON_POOL_DOCUMENT[] = R"JSON({"key":[null,"string",1000,{"nested":[true,"xy"]}],"other":-2.5})JSON";
+
+TEST_F(json_pool_tests, parse_positive)
+{
+    log_trace_func();
+    json_t* value = json_init_from_str(JSON_POOL_DOCUMENT, nullptr);
+    ASSERT_NE(nullptr, value);
+    json_t* copy = json_copy(json_get_by_key(&value, "key"));
+    ASSERT_NE(nullptr, copy);
+    json_deinit(&value);
+    EXPECT_EQ(R"JSON([null,"string",1000,{"nested":[true,"xy"]}])JSON", print(&copy));
+    json_deinit(&copy);
+}
+
+TEST_F(json_pool_tests, nodes_reused_positive)
+{
+    log_trace_func();
+    json_parser_t* parser = json_parser_init();
+    ASSERT_NE(nullptr, parser);
+    const std::string str = JSON_POOL_DOCUMENT;
+    json_t* value = json_parser_parse_buf(parser, str.data(), str.size(), nullptr);
+    json_deinit(&value);
+    {
+        NiceMock<system_mock> mock;
+        EXPECT_CALL(mock, malloc(_)).Times(0);
+        EXPECT_CALL(mock, calloc(_, _)).Times(0);
+        EXPECT_CALL(mock, realloc(_, _)).Times(0);
+        value = json_parser_parse_buf(parser, str.data(), str.size(), nullptr);
+        ASSERT_NE(nullptr, value);
+        json_deinit(&value);
+    }
+    json_parser_deinit(&parser);
+}
+
+TEST_F(json_pool_tests, growing_array_positive)
+{
+    log_trace_func();
+    json_t* array = json_init_from_str("[]", nullptr);
+    ASSERT_NE(nullptr, array);
+    std::string expected = "[";
+    for (size_t i = 0; i < 100; i++) {
+        json_t* elem = json_init_from_value("number", std::to_string(i * 1000).c_str());
+        ASSERT_NE(nullptr, json_set_by_id(&array, &elem, i));
+        expected += (i != 0 ? "," : "") + std::to_string(i * 1000);
+    }
+    EXPECT_EQ(expected + "]", print(&array));
+    json_deinit(&array);
+}
+
+TEST_F(json_pool_tests, disabled_after_alloc_positive)
+{
+    log_trace_func();
+    json_t* value = json_init_from_str(R"JSON({"a":"pooled"})JSON", nullptr);
+    ASSERT_NE(nullptr, value);
+    json_pool_set_enabled(0);
+    json_t* elem = json_init_from_value("string", "heap");
+    ASSERT_NE(nullptr, json_set_by_key(&value, &elem, "b"));
+    for (size_t i = 0; i < 40; i++) {
+        elem = json_init_from_value("null", nullptr);
+        ASSERT_NE(nullptr, json_set_by_key(&value, &elem, std::to_string(i).c_str()));
+    }
+    EXPECT_STREQ("heap", json_get_str(json_get_by_key(&value, "b")));
+    EXPECT_STREQ("pooled", json_get_str(json_get_by_key(&value, "a")));
+    json_deinit(&value);
+}
+
+TEST_F(json_pool_tests, trim_keeps_used_nodes_positive)
+{
+    log_trace_func();
+    json_t* value = json_init_from_str(JSON_POOL_DOCUMENT, nullptr);
+    ASSERT_NE(nullptr, value);
+    json_pool_trim();
+    EXPECT_EQ(JSON_POOL_DOCUMENT, print(&value));
+    json_deinit(&value);
+}
+
+TEST_F(json_pool_tests, released_by_other_thread_positive)
+{
+    log_trace_func();
+    std::vector<std::vector<json_t*>> values(4);
+    std::vector<std::thread> threads;
+    for (auto& thread_values : values) {
+        threads.emplace_back([&thread_values]() {
+            for (size_t i = 0; i < 200; i++) {
+                thread_values.push_back(json_init_from_str(JSON_POOL_DOCUMENT, nullptr));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (auto& thread_values : values) {
+        for (auto& value : thread_values) {
+            ASSERT_NE(nullptr, value);
+            json_deinit(&value);
+        }
+    }
+    EXPECT_LT(0u, json_pool_trim());
+    EXPECT_EQ(0u, json_pool_trim());
+}
+
+TEST_F(json_pool_tests, released_after_thread_cache_flushed_positive)
+{
+    log_trace_func();
+    // key of pool is created first, so cache of thread is flushed before value is released by key of test
+    json_t* value = json_init_from_str(JSON_POOL_DOCUMENT, nullptr);
+    json_deinit(&value);
+    json_pool_trim();
+    pthread_key_t key;
+    ASSERT_EQ(0, pthread_key_create(&key, [](void* data) {
+        json_t* value = static_cast<json_t*>(data);
+        json_deinit(&value);
+    }));
+    std::thread([key]() {
+        json_t* value = json_init_from_str(JSON_POOL_DOCUMENT, nullptr);
+        ASSERT_NE(nullptr, value);
+        pthread_setspecific(key, value);
+    }).join();
+    pthread_key_delete(key);
+    EXPECT_LT(0u, json_pool_trim());
+    EXPECT_EQ(0u, json_pool_trim());
+}
+}
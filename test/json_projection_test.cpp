@@ -0,0 +1,115 @@
+/// Copyright © Alexander Kaluzhnyy
+#include <gtest/gtest.h>
+#include "json.h"
+#include "json_printer.h"
+#include "log.h"
+#include "system_mock.hpp"
+#include <string>
+#include <vector>
+
+namespace json_test {
+
+using namespace ::testing;
+
+class json_projection_tests : public Test {
+protected:
+    json_t* m_object = nullptr;
+    void TearDown() override
+    {
+        json_deinit(&m_object);
+    }
+    void project(const std::string& str, const std::vector<const char*>& paths)
+    {
+        json_deinit(&m_object);
+        static const char* const no_paths[] = { nullptr };
+        m_object = json_init_from_buf_projected(str.data(), str.size(), paths.empty() ? no_paths : paths.data(), paths.size());
+    }
+    void project_and_check(const std::string& str, const std::vector<const char*>& paths, const char* expected)
+    {
+        project(str, paths);
+        ASSERT_NE(nullptr, m_object);
+        char* out = json_sprint(&m_object, 0);
+        EXPECT_STREQ(expected, out);
+        free(out);
+    }
+};
+
+static const char JSON_PROJECTION_DOCUMENT[] = R"JSON( {
+    "a": {"b": 1, "x": [1, 2, {"y": "s\"}]"}]},
+    "c": [5, 6, 7],
+    "d": "skip]",
+    "e~/f": true,
+    "g": 12.5e1
+} )JSON";
+
+TEST_F(json_projection_tests, paths_positive)
+{
+    log_trace_func();
+    project_and_check(JSON_PROJECTION_DOCUMENT, { "/a/b", "/c/1", "/e~0~1f", "/g", "/missing", "/c/10" },
+        R"JSON({"a":{"b":1},"c":[null,6,null],"e~/f":true,"g":12.5e1})JSON");
+}
+
+TEST_F(json_projection_tests, whole_subtree_positive)
+{
+    log_trace_func();
+    project_and_check(JSON_PROJECTION_DOCUMENT, { "/a/x/2", "/a/x" }, R"JSON({"a":{"x":[1,2,{"y":"s\"}]"}]}})JSON");
+    project_and_check(JSON_PROJECTION_DOCUMENT, { "" }, R"JSON({"a":{"b":1,"x":[1,2,{"y":"s\"}]"}]},"c":[5,6,7],"d":"skip]","e~/f":true,"g":12.5e1})JSON");
+    project_and_check(" 42 ", { "" }, "42");
+}
+
+TEST_F(json_projection_tests, nothing_selected_positive)
+{
+    log_trace_func();
+    project_and_check(JSON_PROJECTION_DOCUMENT, {}, "{}");
+    project_and_check(JSON_PROJECTION_DOCUMENT, { "/a/b/c", "/d/0" }, R"JSON({"a":{}})JSON");
+    project_and_check("[[1],{}]", { "/1/q" }, "[null,{}]");
+    project_and_check("\"str\"", { "/a" }, "null");
+}
+
+TEST_F(json_projection_tests, wrong_input_negative)
+{
+    log_trace_func();
+    for (auto str : { R"JSON({"a":[1,}],"b":2})JSON", R"JSON({"a":"not finished)JSON", R"JSON({"a":[1})JSON", R"JSON({"a" 1})JSON",
+             R"JSON({"b":2} tail)JSON", R"JSON({"b":tru})JSON", R"JSON({"a":,"b":2})JSON", "" }) {
+        project(str, { "/b" });
+        EXPECT_EQ(nullptr, m_object) << str;
+    }
+}
+
+TEST_F(json_projection_tests, wrong_path_negative)
+{
+    log_trace_func();
+    for (auto path : { "a", "/~2", "/a~" }) {
+        project(JSON_PROJECTION_DOCUMENT, { path });
+        EXPECT_EQ(nullptr, m_object) << path;
+    }
+    project(JSON_PROJECTION_DOCUMENT, { "/a", nullptr });
+    EXPECT_EQ(nullptr, m_object);
+}
+
+TEST_F(json_projection_tests, skipping_does_not_allocate_positive)
+{
+    log_trace_func();
+    auto count_allocations = [this](const std::string& skipped) {
+        size_t count = 0;
+        NiceMock<system_mock> mock;
+        EXPECT_CALL(mock, calloc(_, _)).WillRepeatedly([&count](size_t nmemb, size_t size) {
+            count++;
+            return real(calloc)(nmemb, size);
+        });
+        EXPECT_CALL(mock, realloc(_, _)).WillRepeatedly([&count](void* ptr, size_t size) {
+            count++;
+            return real(realloc)(ptr, size);
+        });
+        project_and_check("{\"skip\":" + skipped + ",\"id\":7}", { "/id" }, "{\"id\":7}");
+        json_deinit(&m_object);
+        return count;
+    };
+    std::string skipped = "[";
+    for (size_t i = 0; i < 1000; i++) {
+        skipped += R"JSON({"key":"value \" \\ ]","n":[1,2.5,true,null]},)JSON";
+    }
+    skipped.back() = ']';
+    EXPECT_EQ(count_allocations("[]"), count_allocations(skipped));
+}
+}
@@ -0,0 +1,157 @@
+/// Copyright © Alexander Kaluzhnyy
+#include <gtest/gtest.h>
+#include "json.h"
+#include "json_parser.h"
+#include "json_printer.h"
+#include "log.h"
+#include <string>
+
+namespace json_test {
+
+using namespace ::testing;
+
+class json_push_parser_tests : public TestWithParam<size_t> {
+protected:
+    json_push_parser_t* m_parser = nullptr;
+    json_t* m_object = nullptr;
+    char* m_out = nullptr;
+    void SetUp() override
+    {
+        m_parser = json_push_init();
+        ASSERT_NE(nullptr, m_parser);
+    }
+    void TearDown() override
+    {
+        free(m_out);
+        json_deinit(&m_object);
+        json_push_deinit(&m_parser);
+        EXPECT_EQ(nullptr, m_parser);
+    }
+    ///
+    ///@brief Feed str by chunks of given size till value parsed or error
+    ///@param used [out] count of symbols used by value
+    ///
+    json_push_status_t feed(const std::string& str, size_t chunk, size_t* used)
+    {
+        *used = 0;
+        json_push_status_t status = JSON_PUSH_NEED_MORE;
+        while (status == JSON_PUSH_NEED_MORE && *used < str.size()) {
+            size_t consumed = 0;
+            status = json_push_feed(m_parser, str.data() + *used, std::min(chunk, str.size() - *used), &consumed);
+            *used += consumed;
+        }
+        return status;
+    }
+};
+
+static const char JSON_PUSH_DOCUMENT[] = R"JSON( {"key" : [null,true,false,123.5e-1,"str\"ing \u0398\u00e9"],"":{},"e":[ ]} )JSON";
+static const char JSON_PUSH_DOCUMENT_EXPECTED[] = R"JSON({"key":[null,true,false,123.5e-1,"str\"ing Θé"],"":{},"e":[]})JSON";
+
+TEST_P(json_push_parser_tests, chunked_positive)
+{
+    log_trace_func();
+    const std::string str = JSON_PUSH_DOCUMENT;
+    size_t used = 0;
+    ASSERT_EQ(JSON_PUSH_DONE, feed(str, GetParam(), &used));
+    EXPECT_EQ(str.size() - 1, used);
+    m_object = json_push_take(m_parser);
+    ASSERT_NE(nullptr, m_object);
+    EXPECT_EQ(nullptr, json_push_take(m_parser));
+    m_out = json_sprint(&m_object, 0);
+    EXPECT_STREQ(JSON_PUSH_DOCUMENT_EXPECTED, m_out);
+}
+
+TEST_P(json_push_parser_tests, long_string_positive)
+{
+    log_trace_func();
+    const std::string str = "\"" + std::string(1000, 'x') + "\\n\"";
+    size_t used = 0;
+    ASSERT_EQ(JSON_PUSH_DONE, feed(str, GetParam(), &used));
+    EXPECT_EQ(str.size(), used);
+    m_object = json_push_take(m_parser);
+    ASSERT_NE(nullptr, m_object);
+    EXPECT_EQ(std::string(1000, 'x') + "\n", json_get_str(&m_object));
+}
+
+TEST_P(json_push_parser_tests, number_positive)
+{
+    log_trace_func();
+    const std::string str = "-1234567.125";
+    size_t used = 0;
+    ASSERT_EQ(JSON_PUSH_NEED_MORE, feed(str, GetParam(), &used));
+    EXPECT_EQ(str.size(), used);
+    ASSERT_EQ(JSON_PUSH_DONE, json_push_finish(m_parser));
+    m_object = json_push_take(m_parser);
+    ASSERT_NE(nullptr, m_object);
+    m_out = json_sprint(&m_object, 0);
+    EXPECT_STREQ("-1234567.125", m_out);
+}
+
+TEST_P(json_push_parser_tests, sequence_positive)
+{
+    log_trace_func();
+    const std::string str = R"JSON([1] "two" 3 {"four":4})JSON";
+    const char* expected[] = { "[1]", "\"two\"", "3", R"JSON({"four":4})JSON" };
+    size_t pos = 0;
+    for (const char* value : expected) {
+        size_t used = 0;
+        ASSERT_EQ(JSON_PUSH_DONE, feed(str.substr(pos), GetParam(), &used)) << value;
+        pos += used;
+        m_object = json_push_take(m_parser);
+        ASSERT_NE(nullptr, m_object);
+        m_out = json_sprint(&m_object, 0);
+        EXPECT_STREQ(value, m_out);
+        free(m_out);
+        m_out = nullptr;
+        json_deinit(&m_object);
+    }
+    EXPECT_EQ(str.size(), pos);
+}
+
+TEST_P(json_push_parser_tests, wrong_symbol_negative)
+{
+    log_trace_func();
+    size_t used = 0;
+    EXPECT_EQ(JSON_PUSH_ERROR, feed(R"JSON({"key":[1,2,]})JSON", GetParam(), &used));
+    EXPECT_EQ(nullptr, json_push_take(m_parser));
+    ASSERT_EQ(JSON_PUSH_DONE, feed("[3]", GetParam(), &used));
+    m_object = json_push_take(m_parser);
+    ASSERT_NE(nullptr, m_object);
+    m_out = json_sprint(&m_object, 0);
+    EXPECT_STREQ("[3]", m_out);
+}
+
+TEST_P(json_push_parser_tests, unfinished_negative)
+{
+    log_trace_func();
+    size_t used = 0;
+    EXPECT_EQ(JSON_PUSH_NEED_MORE, feed(R"JSON({"key":["val)JSON", GetParam(), &used));
+    EXPECT_EQ(JSON_PUSH_ERROR, json_push_finish(m_parser));
+    EXPECT_EQ(JSON_PUSH_ERROR, json_push_finish(m_parser));
+}
+
+INSTANTIATE_TEST_SUITE_P(chunk_size, json_push_parser_tests, Values(1, 2, 3, 7, 64 * 1024));
+
+TEST(json_push_parser, not_taken_negative)
+{
+    log_trace_func();
+    json_push_parser_t* parser = json_push_init();
+    ASSERT_NE(nullptr, parser);
+    size_t used = 0;
+    EXPECT_EQ(JSON_PUSH_DONE, json_push_feed(parser, "[] []", 5, &used));
+    EXPECT_EQ(2u, used);
+    EXPECT_EQ(JSON_PUSH_ERROR, json_push_feed(parser, " []", 3, &used));
+    json_push_deinit(&parser);
+}
+
+TEST(json_push_parser, max_depth_negative)
+{
+    log_trace_func();
+    json_push_parser_t* parser = json_push_init();
+    ASSERT_NE(nullptr, parser);
+    json_push_set_max_depth(parser, 2);
+    EXPECT_EQ(JSON_PUSH_NEED_MORE, json_push_feed(parser, "[[", 2, nullptr));
+    EXPECT_EQ(JSON_PUSH_ERROR, json_push_feed(parser, "[", 1, nullptr));
+    json_push_deinit(&parser);
+}
+}
@@ -0,0 +1,148 @@
+/// Copyright © Alexander Kaluzhnyy
+#include <gtest/gtest.h>
+#include "json.h"
+#include "json_parser.h"
+#include "log.h"
+#include "system_mock.hpp"
+#include <string>
+
+namespace json_test {
+
+using namespace ::testing;
+
+///
+///@brief Handlers writing events into string, stop after given count of events
+///
+struct sax_recorder {
+    std::string events;
+    size_t stop_after = SIZE_MAX;
+    size_t count = 0;
+
+    static sax_recorder* self(void* data)
+    {
+        return static_cast<sax_recorder*>(data);
+    }
+    static int put(void* data, const std::string& event)
+    {
+        self(data)->events += event + " ";
+        return ++self(data)->count >= self(data)->stop_after;
+    }
+    static const json_sax_t handlers;
+};
+
+const json_sax_t sax_recorder::handlers = {
+    [](void* data) { return put(data, "null"); },
+    [](void* data, int value) { return put(data, value ? "true" : "false"); },
+    [](void* data, const char* str, size_t len) { return put(data, "n:" + std::string(str, len)); },
+    [](void* data, const char* str, size_t len) { return put(data, "s:" + std::string(str, len)); },
+    [](void* data, const char* str, size_t len) { return put(data, "k:" + std::string(str, len)); },
+    [](void* data) { return put(data, "{"); },
+    [](void* data) { return put(data, "}"); },
+    [](void* data) { return put(data, "["); },
+    [](void* data) { return put(data, "]"); },
+};
+
+class json_sax_tests : public Test {
+protected:
+    json_parser_t* m_parser = nullptr;
+    sax_recorder m_recorder;
+    void SetUp() override
+    {
+        m_parser = json_parser_init();
+        ASSERT_NE(nullptr, m_parser);
+    }
+    void TearDown() override
+    {
+        json_parser_deinit(&m_parser);
+    }
+};
+
+static const char JSON_SAX_DOCUMENT[] = R"JSON( {"key":[null,true,false,-12.5e1,"str\"ing\u0000"],"":{},"a":[]} tail)JSON";
+static const char JSON_SAX_EVENTS[] = "{ k:key [ null true false n:-12.5e1 s:str\"ing\0 ] k: { } k:a [ ] } ";
+
+TEST_F(json_sax_tests, events_positive)
+{
+    log_trace_func();
+    size_t consumed = 0;
+    const std::string str = JSON_SAX_DOCUMENT;
+    EXPECT_EQ(0, json_parser_sax_buf(m_parser, &sax_recorder::handlers, &m_recorder, str.data(), str.size(), &consumed));
+    EXPECT_EQ(std::string(JSON_SAX_EVENTS, sizeof(JSON_SAX_EVENTS) - 1), m_recorder.events);
+    EXPECT_EQ(str.size() - 5, consumed);
+}
+
+TEST_F(json_sax_tests, scalar_positive)
+{
+    log_trace_func();
+    size_t consumed = 0;
+    EXPECT_EQ(0, json_parser_sax_buf(m_parser, &sax_recorder::handlers, &m_recorder, "123 ", 4, &consumed));
+    EXPECT_EQ("n:123 ", m_recorder.events);
+    EXPECT_EQ(3u, consumed);
+}
+
+TEST_F(json_sax_tests, null_handlers_positive)
+{
+    log_trace_func();
+    json_sax_t handlers = {};
+    handlers.on_key = sax_recorder::handlers.on_key;
+    const std::string str = JSON_SAX_DOCUMENT;
+    EXPECT_EQ(0, json_parser_sax_buf(m_parser, &handlers, &m_recorder, str.data(), str.size(), nullptr));
+    EXPECT_EQ("k:key k: k:a ", m_recorder.events);
+}
+
+TEST_F(json_sax_tests, stopped_by_handler_negative)
+{
+    log_trace_func();
+    m_recorder.stop_after = 3;
+    const std::string str = JSON_SAX_DOCUMENT;
+    EXPECT_EQ(-1, json_parser_sax_buf(m_parser, &sax_recorder::handlers, &m_recorder, str.data(), str.size(), nullptr));
+    EXPECT_EQ("{ k:key [ ", m_recorder.events);
+}
+
+TEST_F(json_sax_tests, wrong_symbol_negative)
+{
+    log_trace_func();
+    size_t consumed = 0;
+    EXPECT_EQ(-1, json_parser_sax_buf(m_parser, &sax_recorder::handlers, &m_recorder, "[1,{]", 5, &consumed));
+    EXPECT_EQ("[ n:1 { ", m_recorder.events);
+    EXPECT_EQ(4u, consumed);
+}
+
+TEST_F(json_sax_tests, tree_after_sax_positive)
+{
+    log_trace_func();
+    EXPECT_EQ(-1, json_parser_sax_buf(m_parser, &sax_recorder::handlers, &m_recorder, "[[[", 3, nullptr));
+    json_t* value = json_parser_parse_buf(m_parser, "[[1]]", 5, nullptr);
+    ASSERT_NE(nullptr, value);
+    EXPECT_EQ(1u, json_size(&value));
+    json_deinit(&value);
+}
+
+TEST_F(json_sax_tests, no_allocations_positive)
+{
+    log_trace_func();
+    const std::string str = JSON_SAX_DOCUMENT;
+    EXPECT_EQ(0, json_parser_sax_buf(m_parser, &sax_recorder::handlers, &m_recorder, str.data(), str.size(), nullptr));
+    m_recorder.events.reserve(m_recorder.events.size() * 2);
+    NiceMock<system_mock> mock;
+    EXPECT_CALL(mock, malloc(_)).Times(0);
+    EXPECT_CALL(mock, calloc(_, _)).Times(0);
+    EXPECT_CALL(mock, realloc(_, _)).Times(0);
+    EXPECT_EQ(0, json_parser_sax_buf(m_parser, &sax_recorder::handlers, &m_recorder, str.data(), str.size(), nullptr));
+}
+
+static size_t read_str(const char** str, char* buf, size_t size)
+{
+    size_t len = std::min(strlen(*str), size);
+    memcpy(buf, *str, len);
+    *str += len;
+    return len;
+}
+
+TEST_F(json_sax_tests, reader_positive)
+{
+    log_trace_func();
+    const char* iterator = "{\"a\":[1]}";
+    EXPECT_EQ(0, json_parser_sax_reader(m_parser, &sax_recorder::handlers, &m_recorder, (json_read_t)read_str, &iterator));
+    EXPECT_EQ("{ k:a [ n:1 ] } ", m_recorder.events);
+}
+}
@@ -0,0 +1,259 @@
+/// Copyright © Alexander Kaluzhnyy
+#include <gtest/gtest.h>
+#include "json.h"
+#include "json_arena.h"
+#include "json_parser.h"
+#include "json_printer.h"
+#include "log.h"
+#include "system_mock.hpp"
+#include <string>
+
+namespace json_test {
+
+using namespace ::testing;
+
+class json_view_tests : public Test {
+protected:
+    json_parser_t* m_parser = nullptr;
+    void SetUp() override
+    {
+        m_parser = json_parser_init();
+        ASSERT_NE(nullptr, m_parser);
+        json_parser_set_views(m_parser, 1);
+    }
+    void TearDown() override
+    {
+        json_parser_deinit(&m_parser);
+    }
+    json_t* parse(const std::string& str)
+    {
+        json_t* value = json_parser_parse_buf(m_parser, str.data(), str.size(), nullptr);
+        EXPECT_NE(nullptr, value);
+        return value;
+    }
+    static std::string print(json_t** value)
+    {
+        char* out = json_sprint(value, 0);
+        std::string str = out != nullptr ? out : "NULL";
+        free(out);
+        return str;
+    }
+};
+
+static const char JSON_VIEW_DOCUMENT[] = R"JSON({"a":["view","esc\"aped",""],"b":"x","n":1.5,"k":{"view":"tail"}})JSON";
+
+TEST_F(json_view_tests, strings_reference_buffer_positive)
+{
+    log_trace_func();
+    const std::string str = JSON_VIEW_DOCUMENT;
+    json_t* value = parse(str);
+    size_t len = 0;
+    json_t** view = json_get_by_id(json_get_by_key(&value, "a"), 0);
+    EXPECT_EQ(str.data() + str.find("view"), json_get_strn(view, &len));
+    EXPECT_EQ(4u, len);
+    // escaped string is decoded into copy
+    const char* escaped = json_get_strn(json_get_by_id(json_get_by_key(&value, "a"), 1), &len);
+    EXPECT_EQ("esc\"aped", std::string(escaped, len));
+    EXPECT_FALSE(escaped >= str.data() && escaped < str.data() + str.size());
+    EXPECT_EQ(JSON_VIEW_DOCUMENT, print(&value));
+    json_deinit(&value);
+}
+
+TEST_F(json_view_tests, get_str_copy_positive)
+{
+    log_trace_func();
+    const std::string str = R"JSON(["abc","",12])JSON";
+    json_t* value = parse(str);
+    json_t** view = json_get_by_id(&value, 0);
+    const char* copy = json_get_str(view);
+    EXPECT_STREQ("abc", copy);
+    EXPECT_NE(str.data() + 2, copy);
+    // copy is made once
+    EXPECT_EQ(copy, json_get_str(view));
+    EXPECT_STREQ("", json_get_str(json_get_by_id(&value, 1)));
+    size_t len = 0;
+    EXPECT_STREQ("12", json_get_strn(json_get_by_id(&value, 2), &len));
+    EXPECT_EQ(2u, len);
+    json_deinit(&value);
+}
+
+TEST_F(json_view_tests, get_str_copy_negative)
+{
+    log_trace_func();
+    const std::string str = "\"abc\" ";
+    json_t* value = parse(str);
+    NiceMock<system_mock> mock;
+    EXPECT_CALL(mock, calloc(_, _)).WillOnce(Return(nullptr));
+    EXPECT_EQ(nullptr, json_get_str(&value));
+    Mock::VerifyAndClearExpectations(&mock);
+    EXPECT_CALL(mock, calloc(_, _)).WillRepeatedly(Invoke(real(calloc)));
+    EXPECT_STREQ("abc", json_get_str(&value));
+    json_deinit(&value);
+}
+
+TEST_F(json_view_tests, copy_outlives_buffer_positive)
+{
+    log_trace_func();
+    std::string str = JSON_VIEW_DOCUMENT;
+    json_t* value = parse(str);
+    json_t* copy = json_copy(&value);
+    ASSERT_NE(nullptr, copy);
+    json_arena_t* arena = json_arena_init();
+    ASSERT_NE(nullptr, arena);
+    json_t* array = json_arena_init_from_value(arena, "array", nullptr);
+    ASSERT_NE(nullptr, json_set_by_id(&array, &value, 0));
+    str.assign(str.size(), ' ');
+    EXPECT_EQ(JSON_VIEW_DOCUMENT, print(&copy));
+    EXPECT_EQ(std::string("[") + JSON_VIEW_DOCUMENT + "]", print(&array));
+    json_deinit(&copy);
+    json_arena_deinit(&arena);
+}
+
+TEST_F(json_view_tests, stored_views_outlive_buffer_positive)
+{
+    log_trace_func();
+    std::string str = JSON_VIEW_DOCUMENT;
+    json_t* value = parse(str);
+    json_t* other = parse(str);
+    json_t* array = json_init_from_str("[[]]", nullptr);
+    ASSERT_NE(nullptr, array);
+    json_t** inner = json_get_by_id(&array, 0);
+    ASSERT_NE(nullptr, json_set_by_id(inner, &value, 0));
+    ASSERT_NE(nullptr, json_set_by_id(inner, json_get_by_key(&other, "k"), 1));
+    json_deinit(&other);
+    json_t* copy = json_copy(&array);
+    ASSERT_NE(nullptr, copy);
+    str.assign(str.size(), ' ');
+    const std::string expected = std::string("[[") + JSON_VIEW_DOCUMENT + R"JSON(,{"view":"tail"}]])JSON";
+    EXPECT_EQ(expected, print(&array));
+    EXPECT_EQ(expected, print(&copy));
+    json_deinit(&copy);
+    json_deinit(&array);
+}
+
+TEST_F(json_view_tests, arena_positive)
+{
+    log_trace_func();
+    json_arena_t* arena = json_arena_init();
+    ASSERT_NE(nullptr, arena);
+    json_parser_set_arena(m_parser, arena);
+    const std::string str = JSON_VIEW_DOCUMENT;
+    json_t* value = parse(str);
+    EXPECT_STREQ("tail", json_get_str(json_get_by_key(json_get_by_key(&value, "k"), "view")));
+    EXPECT_EQ(JSON_VIEW_DOCUMENT, print(&value));
+    json_parser_set_arena(m_parser, nullptr);
+    json_arena_deinit(&arena);
+}
+
+TEST_F(json_view_tests, reader_copies_positive)
+{
+    log_trace_func();
+    const char* str = "[\"s\"]";
+    json_t* value = json_parser_parse_reader(
+        m_parser, [](void* data, char* buf, size_t size) {
+            const char** str = static_cast<const char**>(data);
+            size_t len = std::min(strlen(*str), size);
+            memcpy(buf, *str, len);
+            *str += len;
+            return len; },
+        &str);
+    ASSERT_NE(nullptr, value);
+    EXPECT_STREQ("s", json_get_str(json_get_by_id(&value, 0)));
+    EXPECT_EQ("[\"s\"]", print(&value));
+    json_deinit(&value);
+}
+
+TEST_F(json_view_tests, views_disabled_positive)
+{
+    log_trace_func();
+    json_parser_set_views(m_parser, 0);
+    const std::string str = "\"abc\"";
+    json_t* value = parse(str);
+    size_t len = 0;
+    EXPECT_NE(str.data() + 1, json_get_strn(&value, &len));
+    EXPECT_EQ(3u, len);
+    json_deinit(&value);
+}
+
+TEST_F(json_view_tests, insitu_positive)
+{
+    log_trace_func();
+    std::string str = R"JSON({"a":["plain","esc\"a\u00e9",""],"n":-1} tail)JSON";
+    size_t consumed = 0;
+    json_t* value = json_parser_parse_insitu(m_parser, str.data(), str.size(), &consumed);
+    ASSERT_NE(nullptr, value);
+    EXPECT_EQ(str.find(" tail"), consumed);
+    json_t** array = json_get_by_key(&value, "a");
+    EXPECT_EQ(str.data() + str.find("plain"), json_get_str(json_get_by_id(array, 0)));
+    const char* escaped = json_get_str(json_get_by_id(array, 1));
+    EXPECT_STREQ("esc\"a\u00e9", escaped);
+    EXPECT_TRUE(escaped >= str.data() && escaped < str.data() + str.size());
+    EXPECT_STREQ("", json_get_str(json_get_by_id(array, 2)));
+    EXPECT_EQ("{\"a\":[\"plain\",\"esc\\\"a\u00e9\",\"\"],\"n\":-1}", print(&value));
+    // keys of copy do not reference data
+    json_t* copy = json_copy(&value);
+    ASSERT_NE(nullptr, copy);
+    json_deinit(&value);
+    str.assign(str.size(), 'x');
+    EXPECT_EQ("{\"a\":[\"plain\",\"esc\\\"a\u00e9\",\"\"],\"n\":-1}", print(&copy));
+    EXPECT_NE(nullptr, json_get_by_key(&copy, "n"));
+    json_deinit(&copy);
+}
+
+TEST_F(json_view_tests, insitu_no_string_allocations_positive)
+{
+    log_trace_func();
+    const std::string document = R"JSON({"a":"x","b\n":["c","d\t"]})JSON";
+    std::string str = document;
+    json_t* value = json_parser_parse_insitu(m_parser, str.data(), str.size(), nullptr);
+    json_deinit(&value);
+    str = document;
+    NiceMock<system_mock> mock;
+    // object, array and nodes of its 2 keys and 3 strings only
+    EXPECT_CALL(mock, calloc(_, _)).Times(2 + 2 + 3).WillRepeatedly(Invoke(real(calloc)));
+    EXPECT_CALL(mock, malloc(_)).Times(0);
+    EXPECT_CALL(mock, realloc(_, _)).Times(0);
+    value = json_parser_parse_insitu(m_parser, str.data(), str.size(), nullptr);
+    ASSERT_NE(nullptr, value);
+    EXPECT_EQ(str.data() + document.find('a'), json_key(&value, 0));
+    EXPECT_EQ(str.data() + document.find('b'), json_key(&value, 1));
+    EXPECT_STREQ("b\n", json_key(&value, 1));
+    json_t** array = json_get_by_key(&value, "b\n");
+    ASSERT_NE(nullptr, array);
+    EXPECT_STREQ("d\t", json_get_str(json_get_by_id(array, 1)));
+    json_deinit(&value);
+}
+
+TEST_F(json_view_tests, insitu_indented_positive)
+{
+    log_trace_func();
+    std::string document = "[\n";
+    for (size_t i = 0; document.size() < 3 * 4096; i++) {
+        document += std::string(i % 11, ' ') + "\"" + std::string(i % 61, 'x') + "\\\"] \\u0041\\\\\",\n";
+    }
+    document += " 0 ]";
+    std::string str = document;
+    json_t* value = json_parser_parse_insitu(m_parser, str.data(), str.size(), nullptr);
+    ASSERT_NE(nullptr, value);
+    json_t* expected = json_init_from_str(document.c_str(), nullptr);
+    ASSERT_NE(nullptr, expected);
+    EXPECT_EQ(print(&expected), print(&value));
+    json_deinit(&expected);
+    json_deinit(&value);
+}
+
+TEST_F(json_view_tests, insitu_negative)
+{
+    log_trace_func();
+    std::string str = R"JSON(["a","b\x"])JSON";
+    EXPECT_EQ(nullptr, json_parser_parse_insitu(m_parser, str.data(), str.size(), nullptr));
+    str = R"JSON(["a","b)JSON";
+    EXPECT_EQ(nullptr, json_parser_parse_insitu(m_parser, str.data(), str.size(), nullptr));
+}
+
+TEST(json_view, nullptr_negative)
+{
+    log_trace_func();
+    json_parser_set_views(nullptr, 1);
+}
+}
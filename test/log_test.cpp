@@ -0,0 +1,227 @@
+/// Copyright © Alexander Kaluzhnyy
+#include <gtest/gtest.h>
+#include "json.h"
+#include "json_log.h"
+#include "log.h"
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace json_test {
+
+using namespace ::testing;
+
+struct log_collector {
+    std::mutex mutex;
+    std::string text;
+    size_t calls = 0;
+    static void sink(void* data, const char* text, size_t len)
+    {
+        auto self = static_cast<log_collector*>(data);
+        std::lock_guard<std::mutex> lock(self->mutex);
+        self->text.append(text, len);
+        self->calls++;
+    }
+    size_t count(const std::string& str)
+    {
+        size_t count = 0;
+        for (size_t pos = text.find(str); pos != std::string::npos; pos = text.find(str, pos + 1)) {
+            count++;
+        }
+        return count;
+    }
+};
+
+class log_tests : public Test {
+protected:
+    json_log_level_t m_level = JSON_LOG_NONE;
+    // outlives trace exit of test body
+    log_collector m_collector;
+    void SetUp() override
+    {
+        m_level = json_log_get_level();
+    }
+    void TearDown() override
+    {
+        json_log_async_stop();
+        json_log_set_sink(nullptr, nullptr);
+        json_log_set_level(m_level);
+    }
+};
+
+static int log_test_arg_calls = 0;
+
+static int log_test_arg(void)
+{
+    return ++log_test_arg_calls;
+}
+
+TEST_F(log_tests, default_level_positive)
+{
+    log_trace_func();
+    EXPECT_EQ(JSON_LOG_ERROR, m_level);
+}
+
+TEST_F(log_tests, level_trace_positive)
+{
+    log_trace_func();
+#ifdef JSON_NO_LOG
+    GTEST_SKIP() << "trace is compiled out";
+#endif
+    json_log_set_sink(log_collector::sink, &m_collector);
+    json_log_set_level(JSON_LOG_TRACE);
+    json_t* value = json_init_from_str("[1]", nullptr);
+    json_deinit(&value);
+    json_log_set_level(JSON_LOG_NONE);
+    EXPECT_NE(std::string::npos, m_collector.text.find("json_init_from_str")) << m_collector.text;
+    EXPECT_NE(std::string::npos, m_collector.text.find("debug:")) << m_collector.text;
+}
+
+TEST_F(log_tests, level_none_positive)
+{
+    log_trace_func();
+    json_log_set_level(JSON_LOG_NONE);
+    EXPECT_EQ(JSON_LOG_NONE, json_log_get_level());
+    internal::CaptureStdout();
+    json_t* value = json_init_from_str("[1,\"s\"]", nullptr);
+    ASSERT_NE(nullptr, value);
+    EXPECT_EQ(nullptr, json_get_by_id(&value, 5));
+    json_deinit(&value);
+    log_error_msg("%i", log_test_arg());
+    EXPECT_EQ("", internal::GetCapturedStdout());
+    // arguments of skipped messages are not evaluated
+    EXPECT_EQ(0, log_test_arg_calls);
+}
+
+TEST_F(log_tests, level_error_positive)
+{
+    log_trace_func();
+    json_log_set_level(JSON_LOG_ERROR);
+    internal::CaptureStdout();
+    log_debug_msg("%i", log_test_arg());
+    const int line = __LINE__ + 1;
+    log_error_msg("%i", 5);
+    const std::string out = internal::GetCapturedStdout();
+    EXPECT_NE(std::string::npos, out.find("log_test.cpp:" + std::to_string(line) + ":error:5\n")) << out;
+    EXPECT_EQ(std::string::npos, out.find("debug")) << out;
+    EXPECT_EQ(0, log_test_arg_calls);
+}
+
+TEST_F(log_tests, sync_sink_positive)
+{
+    log_trace_func();
+    json_log_set_sink(log_collector::sink, &m_collector);
+    json_log_set_level(JSON_LOG_ERROR);
+    log_error_msg("value:%i", 7);
+    json_log_set_level(JSON_LOG_NONE);
+    EXPECT_EQ(1u, m_collector.calls);
+    EXPECT_NE(std::string::npos, m_collector.text.find("error:value:7\n")) << m_collector.text;
+}
+
+TEST_F(log_tests, async_positive)
+{
+    log_trace_func();
+    static const size_t THREADS = 4;
+    static const size_t MESSAGES = 500;
+    json_log_set_sink(log_collector::sink, &m_collector);
+    json_log_set_level(JSON_LOG_ERROR);
+    ASSERT_EQ(0, json_log_async_start(THREADS * MESSAGES * 2));
+    EXPECT_EQ(-1, json_log_async_start(1));
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < THREADS; i++) {
+        threads.emplace_back([i]() {
+            for (size_t j = 0; j < MESSAGES; j++) {
+                log_error_msg("thread %zu message %zu", i, j);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    json_log_flush();
+    {
+        std::lock_guard<std::mutex> lock(m_collector.mutex);
+        EXPECT_EQ(THREADS * MESSAGES, m_collector.count("error:thread "));
+        EXPECT_NE(std::string::npos, m_collector.text.find("error:thread 3 message 499\n"));
+        // records are written by batches
+        EXPECT_LT(m_collector.calls, THREADS * MESSAGES);
+    }
+    log_error_msg("last");
+    json_log_async_stop();
+    EXPECT_EQ(1u, m_collector.count("error:last\n"));
+}
+
+TEST_F(log_tests, async_full_ring_positive)
+{
+    log_trace_func();
+    json_log_set_sink(log_collector::sink, &m_collector);
+    json_log_set_level(JSON_LOG_ERROR);
+    ASSERT_EQ(0, json_log_async_start(0));
+    // drain thread is sleeping, so burst overflows ring
+    for (size_t i = 0; i < 100000; i++) {
+        log_error_msg("message %zu", i);
+    }
+    json_log_async_stop();
+    size_t dropped = 0;
+    for (size_t pos = m_collector.text.find("log:"); pos != std::string::npos; pos = m_collector.text.find("log:", pos + 1)) {
+        dropped += std::stoul(m_collector.text.substr(pos + 4));
+    }
+    EXPECT_LT(0u, dropped);
+    EXPECT_EQ(100000u, m_collector.count("error:message ") + dropped);
+}
+
+TEST_F(log_tests, sync_long_message_positive)
+{
+    log_trace_func();
+    const std::string message(3000, 'x');
+    json_log_set_sink(log_collector::sink, &m_collector);
+    json_log_set_level(JSON_LOG_ERROR);
+    log_error_msg("%s", message.c_str());
+    json_log_set_level(JSON_LOG_NONE);
+    EXPECT_EQ(1u, m_collector.calls);
+    EXPECT_NE(std::string::npos, m_collector.text.find("error:" + message + "\n")) << m_collector.text;
+}
+
+TEST_F(log_tests, async_long_message_truncated_positive)
+{
+    log_trace_func();
+    const std::string message(3000, 'x');
+    json_log_set_sink(log_collector::sink, &m_collector);
+    json_log_set_level(JSON_LOG_ERROR);
+    ASSERT_EQ(0, json_log_async_start(0));
+    log_error_msg("%s", message.c_str());
+    json_log_async_stop();
+    json_log_set_level(JSON_LOG_NONE);
+    EXPECT_EQ(std::string::npos, m_collector.text.find(message)) << m_collector.text;
+    EXPECT_NE(std::string::npos, m_collector.text.find("xxx...\n")) << m_collector.text;
+}
+
+TEST_F(log_tests, async_stop_while_logging_positive)
+{
+    log_trace_func();
+    static const size_t THREADS = 4;
+    json_log_set_sink(log_collector::sink, &m_collector);
+    json_log_set_level(JSON_LOG_ERROR);
+    bool stop = false;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < THREADS; i++) {
+        threads.emplace_back([&stop]() {
+            while (!__atomic_load_n(&stop, __ATOMIC_RELAXED)) {
+                log_error_msg("message");
+            }
+        });
+    }
+    // ring is freed by stop while producers keep logging
+    for (size_t i = 0; i < 50; i++) {
+        ASSERT_EQ(0, json_log_async_start(0));
+        json_log_async_stop();
+    }
+    __atomic_store_n(&stop, true, __ATOMIC_RELAXED);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    json_log_set_level(JSON_LOG_NONE);
+    EXPECT_NE(0u, m_collector.count("error:message\n"));
+}
+}
@@ -0,0 +1,83 @@
+/// Copyright © Alexander Kaluzhnyy
+#include <gtest/gtest.h>
+#include "scan.h"
+#include "log.h"
+#include <string>
+
+namespace json_test {
+
+using namespace ::testing;
+
+class scan_tests : public TestWithParam<const scan_impl_t*> {
+};
+
+static std::string make_spaces(size_t count)
+{
+    static const char spaces[] = " \t\n\v\f\r";
+    std::string ret;
+    for (size_t i = 0; i < count; i++) {
+        ret += spaces[i % (sizeof(spaces) - 1)];
+    }
+    return ret;
+}
+
+TEST_P(scan_tests, spaces_stop_on_symbol_positive)
+{
+    log_trace_func();
+    for (size_t count = 0; count < 100; count++) {
+        for (char symbol : { 'x', '\0', '\b', '\x0E', '\x80', '\xFF', '"' }) {
+            std::string data = make_spaces(count) + symbol + "   ";
+            const char* found = GetParam()->spaces(data.data(), data.data() + data.size());
+            ASSERT_EQ(data.data() + count, found) << GetParam()->name << " count:" << count;
+        }
+    }
+}
+
+TEST_P(scan_tests, spaces_stop_on_end_positive)
+{
+    log_trace_func();
+    for (size_t count = 0; count < 100; count++) {
+        std::string data = make_spaces(count) + "x";
+        const char* end = data.data() + count;
+        ASSERT_EQ(end, GetParam()->spaces(data.data(), end)) << GetParam()->name << " count:" << count;
+    }
+}
+
+TEST_P(scan_tests, string_stop_on_special_positive)
+{
+    log_trace_func();
+    for (size_t count = 0; count < 100; count++) {
+        for (char symbol : { '"', '\\', '\0', '\x01', '\n', '\x1F' }) {
+            std::string data = std::string(count, 'a') + symbol + "bbb";
+            const char* found = GetParam()->string(data.data(), data.data() + data.size());
+            ASSERT_EQ(data.data() + count, found) << GetParam()->name << " count:" << count;
+        }
+    }
+}
+
+TEST_P(scan_tests, string_skip_plain_positive)
+{
+    log_trace_func();
+    std::string data;
+    for (int symbol = 0x20; symbol <= 0xFF; symbol++) {
+        if (symbol != '"' && symbol != '\\') {
+            data += (char)symbol;
+        }
+    }
+    const char* end = data.data() + data.size();
+    EXPECT_EQ(end, GetParam()->string(data.data(), end)) << GetParam()->name;
+}
+
+static std::vector<const scan_impl_t*> scan_impls()
+{
+    std::vector<const scan_impl_t*> ret;
+    for (auto impl = scan_impl_list(); *impl != nullptr; impl++) {
+        ret.push_back(*impl);
+    }
+    return ret;
+}
+
+INSTANTIATE_TEST_SUITE_P(impl, scan_tests, ValuesIn(scan_impls()), [](const TestParamInfo<const scan_impl_t*>& info) {
+    return std::string { info.param->name };
+});
+}